@@ -0,0 +1,93 @@
+# Link time and profile-guided optimisation of bond_switch_simulator.exe and libnetmc, included from src/CMakeLists.txt
+#
+# NETMC_PGO configures an instrumented copy of the simulator in pgo/instrumented, runs the training simulation in
+# run/pgo_training with it, then compiles the simulator with the recorded profile. The netmc_pgo_speedup target
+# builds a plain release copy in pgo/baseline and compares the two on the training simulation.
+
+set(NETMC_TARGET bond_switch_simulator.exe)
+set(NETMC_OPTIMISED_TARGETS netmc ${NETMC_TARGET})
+set(PGO_DIR ${CMAKE_BINARY_DIR}/pgo)
+
+if(NETMC_LTO OR NETMC_PGO OR NETMC_PGO_STAGE STREQUAL "GENERATE")
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT is_ipo_supported OUTPUT ipo_output)
+    if(is_ipo_supported)
+        set_property(TARGET ${NETMC_OPTIMISED_TARGETS} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+    else()
+        message(WARNING "Link time optimisation is not supported: ${ipo_output}")
+    endif()
+endif()
+
+if(NOT NETMC_PGO AND NOT NETMC_PGO_STAGE STREQUAL "GENERATE")
+    return()
+endif()
+
+# GCC writes one profile per object, named by its path relative to the build directory so the two builds match.
+# Clang writes raw profiles that are merged after training.
+if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    set(PGO_GENERATE_FLAGS -fprofile-generate=${NETMC_PGO_PROFILE_DIR} -fprofile-update=atomic
+                           -fprofile-prefix-path=${CMAKE_BINARY_DIR})
+    set(PGO_USE_FLAGS -fprofile-use=${PGO_DIR}/profile -fprofile-partial-training
+                      -fprofile-prefix-path=${CMAKE_BINARY_DIR} -Wno-missing-profile)
+elseif(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "NETMC_PGO with Clang needs llvm-profdata")
+    endif()
+    set(PGO_GENERATE_FLAGS -fprofile-instr-generate=${NETMC_PGO_PROFILE_DIR}/netmc-%p.profraw)
+    set(PGO_USE_FLAGS -fprofile-instr-use=${PGO_DIR}/profile/netmc.profdata)
+else()
+    message(FATAL_ERROR "NETMC_PGO is only supported with GCC or Clang, not ${CMAKE_CXX_COMPILER_ID}")
+endif()
+
+if(NETMC_PGO_STAGE STREQUAL "GENERATE")
+    foreach(target ${NETMC_OPTIMISED_TARGETS})
+        target_compile_options(${target} PRIVATE ${PGO_GENERATE_FLAGS})
+        target_link_libraries(${target} PRIVATE ${PGO_GENERATE_FLAGS})
+    endforeach()
+    return()
+endif()
+
+# Settings passed on to the instrumented and baseline builds so they are compiled the same way as this one
+set(PGO_FORWARDED_ARGS
+    -DCMAKE_BUILD_TYPE=Release
+    -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+    -DCMAKE_C_COMPILER=${CMAKE_C_COMPILER}
+)
+file(GLOB PGO_SOURCES ${CMAKE_SOURCE_DIR}/src/*.cpp ${CMAKE_SOURCE_DIR}/include/*.h ${CMAKE_SOURCE_DIR}/include/*.tpp)
+file(GLOB_RECURSE PGO_TRAINING_FILES ${CMAKE_SOURCE_DIR}/run/pgo_training/*)
+
+add_custom_command(
+    OUTPUT ${PGO_DIR}/profile.stamp
+    COMMAND ${CMAKE_COMMAND} -E remove_directory ${PGO_DIR}/profile
+    COMMAND ${CMAKE_COMMAND} -S ${CMAKE_SOURCE_DIR} -B ${PGO_DIR}/instrumented ${PGO_FORWARDED_ARGS}
+            -DNETMC_PGO=OFF -DNETMC_PGO_STAGE=GENERATE -DNETMC_PGO_PROFILE_DIR=${PGO_DIR}/profile
+            -DEXEC_OUTPUT_PATH=${PGO_DIR}/instrumented/bin
+    COMMAND ${CMAKE_COMMAND} --build ${PGO_DIR}/instrumented --target ${NETMC_TARGET}
+    COMMAND ${CMAKE_COMMAND} -DEXE=${PGO_DIR}/instrumented/bin/${NETMC_TARGET} -DWORK_DIR=${PGO_DIR}/training
+            -DSOURCE_DIR=${CMAKE_SOURCE_DIR} -DPROFILE_DIR=${PGO_DIR}/profile -DPROFDATA=${LLVM_PROFDATA}
+            -P ${CMAKE_SOURCE_DIR}/cmake/pgo_training.cmake
+    COMMAND ${CMAKE_COMMAND} -E touch ${PGO_DIR}/profile.stamp
+    DEPENDS ${PGO_SOURCES} ${PGO_TRAINING_FILES} ${CMAKE_SOURCE_DIR}/cmake/pgo_training.cmake
+    COMMENT "Training the profile-guided optimisation profile"
+    VERBATIM
+)
+add_custom_target(netmc_pgo_profile DEPENDS ${PGO_DIR}/profile.stamp)
+foreach(target ${NETMC_OPTIMISED_TARGETS})
+    add_dependencies(${target} netmc_pgo_profile)
+    target_compile_options(${target} PRIVATE ${PGO_USE_FLAGS})
+    target_link_libraries(${target} PRIVATE ${PGO_USE_FLAGS})
+    get_target_property(PGO_TARGET_SOURCES ${target} SOURCES)
+    set_source_files_properties(${PGO_TARGET_SOURCES} PROPERTIES OBJECT_DEPENDS ${PGO_DIR}/profile.stamp)
+endforeach()
+
+add_custom_target(netmc_pgo_speedup
+    COMMAND ${CMAKE_COMMAND} -S ${CMAKE_SOURCE_DIR} -B ${PGO_DIR}/baseline ${PGO_FORWARDED_ARGS}
+            -DNETMC_PGO=OFF -DNETMC_LTO=OFF -DEXEC_OUTPUT_PATH=${PGO_DIR}/baseline/bin
+    COMMAND ${CMAKE_COMMAND} --build ${PGO_DIR}/baseline --target ${NETMC_TARGET}
+    COMMAND ${CMAKE_COMMAND} -DEXE=$<TARGET_FILE:${NETMC_TARGET}> -DBASELINE_EXE=${PGO_DIR}/baseline/bin/${NETMC_TARGET}
+            -DWORK_DIR=${PGO_DIR}/speedup -DSOURCE_DIR=${CMAKE_SOURCE_DIR} -P ${CMAKE_SOURCE_DIR}/cmake/pgo_training.cmake
+    DEPENDS ${NETMC_TARGET}
+    COMMENT "Comparing the optimised build with a plain release build on the training simulation"
+    VERBATIM
+)
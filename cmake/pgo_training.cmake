@@ -0,0 +1,71 @@
+# Runs the bundled training simulation, called in script mode by the targets in pgo.cmake
+#
+# cmake -DEXE=<simulator> -DWORK_DIR=<dir> -DSOURCE_DIR=<repository> [-DPROFDATA=<llvm-profdata> -DPROFILE_DIR=<dir>]
+#       [-DBASELINE_EXE=<simulator>] -P pgo_training.cmake
+#
+# Without BASELINE_EXE the simulation is run once with EXE, and any raw Clang profiles in PROFILE_DIR are merged.
+# With BASELINE_EXE the simulation is run with both and the speedup of EXE over BASELINE_EXE is reported.
+
+# Run the training simulation in a fresh copy of the training inputs and get its mean time per step
+function(run_training exe work_dir time_per_step)
+    file(REMOVE_RECURSE ${work_dir})
+    file(COPY ${SOURCE_DIR}/run/pgo_training/input_files DESTINATION ${work_dir})
+    file(COPY ${SOURCE_DIR}/run/input_files/lammps_files/lammps_script.txt
+              ${SOURCE_DIR}/run/input_files/lammps_files/lammps_potential.txt
+         DESTINATION ${work_dir}/input_files/lammps_files)
+    file(MAKE_DIRECTORY ${work_dir}/output_files)
+    message(STATUS "Running training simulation with ${exe}")
+    execute_process(COMMAND ${exe} WORKING_DIRECTORY ${work_dir} RESULT_VARIABLE result OUTPUT_QUIET)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Training simulation failed, see ${work_dir}/output_files/bond_switch_simulator.log")
+    endif()
+
+    # The values after the footer description are the run statistics, the eighth being the average time per step
+    file(STRINGS ${work_dir}/output_files/bss_stats.csv lines)
+    list(FIND lines "The following line is a few statistics about the simulation" footer)
+    math(EXPR values "${footer} + 2")
+    list(GET lines ${values} statistics)
+    string(REPLACE "," ";" statistics "${statistics}")
+    list(GET statistics 7 step_time)
+    string(STRIP "${step_time}" step_time)
+    set(${time_per_step} ${step_time} PARENT_SCOPE)
+endfunction()
+
+# CMake only has integer arithmetic, so convert a time in microseconds to nanoseconds
+function(to_nanoseconds microseconds nanoseconds)
+    if(NOT microseconds MATCHES "^([0-9]+)(\\.([0-9]*))?$")
+        message(FATAL_ERROR "Cannot read time per step: ${microseconds}")
+    endif()
+    set(whole ${CMAKE_MATCH_1})
+    string(SUBSTRING "${CMAKE_MATCH_3}000" 0 3 fraction)
+    math(EXPR result "${whole} * 1000 + ${fraction}")
+    set(${nanoseconds} ${result} PARENT_SCOPE)
+endfunction()
+
+if(NOT DEFINED BASELINE_EXE)
+    run_training(${EXE} ${WORK_DIR} step_time)
+    message(STATUS "Training simulation took ${step_time} us per step")
+    if(PROFDATA)
+        file(GLOB raw_profiles ${PROFILE_DIR}/*.profraw)
+        execute_process(COMMAND ${PROFDATA} merge -output=${PROFILE_DIR}/netmc.profdata ${raw_profiles}
+                        RESULT_VARIABLE result)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "Failed to merge profiles in ${PROFILE_DIR}")
+        endif()
+    endif()
+    return()
+endif()
+
+run_training(${BASELINE_EXE} ${WORK_DIR}/baseline baseline_time)
+run_training(${EXE} ${WORK_DIR}/optimised optimised_time)
+to_nanoseconds(${baseline_time} baseline_nanoseconds)
+to_nanoseconds(${optimised_time} optimised_nanoseconds)
+math(EXPR speedup "(100 * ${baseline_nanoseconds}) / ${optimised_nanoseconds}")
+math(EXPR speedup_units "${speedup} / 100")
+math(EXPR speedup_hundredths "${speedup} % 100")
+if(speedup_hundredths LESS 10)
+    set(speedup_hundredths "0${speedup_hundredths}")
+endif()
+message(STATUS "Release build: ${baseline_time} us per step")
+message(STATUS "Optimised build: ${optimised_time} us per step")
+message(STATUS "Speedup: ${speedup_units}.${speedup_hundredths}x")
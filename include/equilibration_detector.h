@@ -0,0 +1,39 @@
+// Detection of when the sampled observables of a Monte Carlo stage have stopped drifting
+#ifndef EQUILIBRATION_DETECTOR_H
+#define EQUILIBRATION_DETECTOR_H
+
+#include <cstddef>
+#include <vector>
+
+struct EquilibrationDetector {
+    static constexpr int MIN_BLOCKS = 16; // Fewest blocks used to estimate the standard error of a mean
+
+    // Mean of a series of correlated samples and the uncertainty in it
+    struct SeriesStatistics {
+        double mean = 0.0;
+        double standardError = 0.0; // From the plateau of the blocked standard errors
+        double inefficiency = 1.0;  // Number of samples per independent sample, twice the integrated autocorrelation time
+    };
+
+    bool isEnabled = false;
+    int minEffectiveSamples = 0; // Effective samples needed in every observable after equilibration
+    double tolerance = 0.0;      // Largest allowed drift in standard errors between the start and end of the kept samples
+
+    std::vector<int> steps;                       // Step of each sample
+    std::vector<std::vector<double>> observables; // Samples of each observable, in order
+    size_t nextCheck = 0;                         // Number of samples at which to test for equilibration again
+
+    bool isEquilibrated = false;
+    int equilibrationStep = -1;     // Step of the first sample after equilibration, -1 until equilibrated
+    double effectiveSamples = 0.0;  // Smallest effective sample size of any observable after equilibration
+
+    EquilibrationDetector();
+    EquilibrationDetector(const bool &isEnabledArg, const int &minEffectiveSamplesArg, const double &toleranceArg);
+
+    void addSample(const int &step, const std::vector<double> &values);
+    bool check();
+
+    static SeriesStatistics getStatistics(const double *values, const size_t &numValues);
+};
+
+#endif // EQUILIBRATION_DETECTOR_H
@@ -0,0 +1,52 @@
+// Draws the base network into PPM movie frames on background threads, without going through LAMMPS
+#ifndef FRAME_RENDERER_H
+#define FRAME_RENDERER_H
+
+#include "network.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct FrameRenderer {
+    // Copy of everything needed to draw a frame, taken on the Monte Carlo thread
+    struct Snapshot {
+        int frameNumber;
+        std::vector<double> nodeCoords; // 1D vector of pairs
+        std::vector<int> bonds;         // IDs of the nodes in every bond (1D vector of pairs)
+        std::vector<int> bondRings;     // IDs of the rings either side of every bond, -1 if not found (1D vector of pairs)
+        std::vector<double> ringCoords; // 1D vector of pairs
+        std::vector<int> ringSizes;
+    };
+
+    std::string directory;          // Folder the frames are written to
+    std::vector<double> dimensions; // Periodic boundary of the network
+    double scale = 1.0;             // Pixels per unit length
+    int width = 0;
+    int height = 0;
+    bool isColouringRings = false; // Fill rings with a colour for their size
+    size_t maxQueuedFrames = 0;    // Capturing waits for the workers when this many frames are queued
+    int numFrames = 0;             // Number of frames captured
+
+    std::deque<Snapshot> queue;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    bool isStopping = false;
+    std::string error; // Reason the first frame that could not be written failed
+    std::vector<std::thread> workers;
+
+    FrameRenderer(const std::string &directoryArg, const std::vector<double> &dimensionsArg, const bool &isColouringRingsArg,
+                  const int &numThreads);
+    ~FrameRenderer();
+
+    void capture(const Network &baseNetwork, const Network &ringNetwork);
+    void finish();
+    void stopWorkers();
+    void work();
+    void render(const Snapshot &snapshot) const;
+};
+
+#endif // FRAME_RENDERER_H
@@ -0,0 +1,40 @@
+// Half-edge (doubly connected edge list) view of the base network with the rings as faces, in flat arrays
+#ifndef HALF_EDGE_MESH_H
+#define HALF_EDGE_MESH_H
+
+#include "network.h"
+#include <vector>
+
+struct HalfEdgeMesh {
+    // Bond k is the pair of half-edges 2k and 2k + 1, so the twin of half-edge e is e ^ 1
+    std::vector<int> origins;       // Base node every half-edge leaves
+    std::vector<int> rotationNext;  // Next half-edge clockwise around the same origin
+    std::vector<int> rotationPrev;  // Previous half-edge clockwise around the same origin
+    std::vector<int> faces;         // Ring every half-edge runs around
+    std::vector<int> vertexEdges;   // A half-edge leaving every base node
+    std::vector<int> faceEdges;     // A half-edge running around every ring
+
+    HalfEdgeMesh();
+    HalfEdgeMesh(const Network &baseNetwork, const Network &ringNetwork);
+
+    int getDestination(const int &halfEdge) const;
+    int getNext(const int &halfEdge) const;
+    int getPrev(const int &halfEdge) const;
+    int findHalfEdge(const int &node1, const int &node2) const;
+
+    std::vector<int> getNeighbours(const int &node) const;
+    std::vector<int> getFaceNodes(const int &face) const;
+    int getFaceSize(const int &face) const;
+    double getFaceArea(const int &face, const std::vector<double> &coords, const std::vector<double> &dimensions) const;
+    double getFacePerimeter(const int &face, const std::vector<double> &coords, const std::vector<double> &dimensions) const;
+
+    void switchBond(const int &atom1, const int &atom2, const int &breakNode1, const int &breakNode2);
+    void moveBeside(const int &halfEdge, const int &centralEdge);
+    void swapRotationSlots(const int &halfEdge1, const int &halfEdge2);
+    void relabelFace(const int &halfEdge, const std::vector<int> &changedEdges);
+
+    bool checkConsistency(const Network &baseNetwork, const Network &ringNetwork, const LoggerPtr &logger) const;
+    size_t getMemoryUsage() const;
+};
+
+#endif // HALF_EDGE_MESH_H
@@ -26,13 +26,36 @@ enum class StructureType { GRAPHENE,
 
 enum class SelectionType {
     RANDOM,
-    EXPONENTIAL_DECAY
+    EXPONENTIAL_DECAY,
+    STRAIN
+};
+
+enum class MovieRenderer {
+    LAMMPS,
+    NATIVE
+};
+
+enum class NodeOrdering {
+    ORIGINAL,
+    HILBERT,
+    REVERSE_CUTHILL_MCKEE
+};
+
+enum class OrderParameter {
+    ENERGY,
+    HEXAGON_FRACTION
+};
+
+enum class ActiveRegion {
+    NONE,
+    SHELLS,
+    RADIUS
 };
 
 struct InputData {
     // Used for error messages
     int lineNumber = 0;
-    std::ifstream inputFile;
+    std::stringstream inputFile; // Contents of the input file
 
     // Network Restrictions Data
     int minRingSize;
@@ -40,6 +63,9 @@ struct InputData {
     double maximumBondLength;
     double maximumAngle;
     bool isFixRingsEnabled;
+    ActiveRegion activeRegion;
+    int activeRegionShells;
+    double activeRegionRadius;
 
     // Bond Selection Process Data
     int randomSeed;
@@ -52,14 +78,53 @@ struct InputData {
     double annealingEndTemperature;
     int thermalisationSteps;
     int annealingSteps;
+    double topologyOnlyTemperature;
+    int topologyOnlyRelaxInterval;
 
     // Analysis Data
     int analysisWriteInterval;
     bool writeMovie;
+    MovieRenderer movieRenderer;
+    bool colourRingsInMovie;
+    bool stopWhenEquilibrated;
+    int equilibrationEffectiveSamples;
+    double equilibrationTolerance;
+    double ringAreaTolerance;
+    int heatmapGridSize;
+
+    // Performance Data
+    int topologyCacheSize;
+    bool skipRelaxationOnCacheHit;
+    bool reuseProposalOutcomes;
+    bool pipelineProposals;
+    bool isLeanMemory;
+    bool deriveRingNetwork;
+    bool useRelaxationTemplates;
+    int switchBatchSize;
+    int batchRegionRadius;
+    int atomSortInterval;
+    NodeOrdering nodeOrdering;
+    int autotuneMoves;
+    double autotuneEnergyTolerance;
+    int topologyAuditInterval;
+    int packedReplicas;
+
+    // Sampling Data
+    bool isWangLandauEnabled;
+    OrderParameter wangLandauOrderParameter;
+    double wangLandauMinimum;
+    double wangLandauMaximum;
+    int wangLandauBins;
+    double wangLandauFlatness;
+    double wangLandauFinalModification;
+    int wangLandauMaxSteps;
+    int wangLandauWalkers;
 
     LoggerPtr logger;
 
     InputData(const std::string &filePath, const LoggerPtr &logger);
+    InputData(std::istream &input, const LoggerPtr &logger);
+    void read();
 
     // Declare template functions
     template <typename T>
@@ -77,6 +142,8 @@ struct InputData {
     void readBondSelectionProcess();
     void readTemperatureSchedule();
     void readAnalysis();
+    void readPerformance();
+    void readSampling();
 
     void checkFileExists(const std::string &filename) const;
     void validate() const;
@@ -51,13 +51,51 @@ void InputData::readWord(const std::string &word, T &variable, const std::string
             variable = SelectionType::RANDOM;
         } else if (word == "Weighted") {
             variable = SelectionType::EXPONENTIAL_DECAY;
+        } else if (word == "Strain") {
+            variable = SelectionType::STRAIN;
         } else {
             throw std::runtime_error("Invalid selection type: " + word + " in section: " + section + " on line: " + std::to_string(lineNumber));
         }
+    } else if constexpr (std::is_same_v<T, MovieRenderer>) {
+        if (word == "LAMMPS") {
+            variable = MovieRenderer::LAMMPS;
+        } else if (word == "Native") {
+            variable = MovieRenderer::NATIVE;
+        } else {
+            throw std::runtime_error("Invalid movie renderer: " + word + " in section: " + section + " on line: " + std::to_string(lineNumber));
+        }
+    } else if constexpr (std::is_same_v<T, NodeOrdering>) {
+        if (word == "Original") {
+            variable = NodeOrdering::ORIGINAL;
+        } else if (word == "Hilbert") {
+            variable = NodeOrdering::HILBERT;
+        } else if (word == "RCM") {
+            variable = NodeOrdering::REVERSE_CUTHILL_MCKEE;
+        } else {
+            throw std::runtime_error("Invalid node ordering: " + word + " in section: " + section + " on line: " + std::to_string(lineNumber));
+        }
+    } else if constexpr (std::is_same_v<T, OrderParameter>) {
+        if (word == "Energy") {
+            variable = OrderParameter::ENERGY;
+        } else if (word == "HexagonFraction") {
+            variable = OrderParameter::HEXAGON_FRACTION;
+        } else {
+            throw std::runtime_error("Invalid order parameter: " + word + " in section: " + section + " on line: " + std::to_string(lineNumber));
+        }
+    } else if constexpr (std::is_same_v<T, ActiveRegion>) {
+        if (word == "None") {
+            variable = ActiveRegion::NONE;
+        } else if (word == "Shells") {
+            variable = ActiveRegion::SHELLS;
+        } else if (word == "Radius") {
+            variable = ActiveRegion::RADIUS;
+        } else {
+            throw std::runtime_error("Invalid active region: " + word + " in section: " + section + " on line: " + std::to_string(lineNumber));
+        }
     } else if constexpr (std::is_same_v<T, std::string>) {
         variable = word;
     } else {
-        throw std::invalid_argument("Cannot read word for type T. T must be int, double, bool, StructureType, SelectionType or std::string.");
+        throw std::invalid_argument("Cannot read word for type T. T must be int, double, bool, StructureType, SelectionType, MovieRenderer, NodeOrdering, OrderParameter, ActiveRegion or std::string.");
     }
 }
 
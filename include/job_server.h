@@ -0,0 +1,51 @@
+// Long-running server that runs simulation jobs from a spool directory in a pool of forked worker processes, so that
+// each job skips process startup and reuses the LAMMPS instance left by the previous job of its worker
+#ifndef JOB_SERVER_H
+#define JOB_SERVER_H
+
+#include "input_data.h"
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A job read from a .job file in the spool directory
+struct JobDescription {
+    std::filesystem::path inputDirectory;  // Folder holding bss_parameters.txt, bss_network and lammps_files
+    std::filesystem::path outputDirectory; // Folder the job runs in, written to as ./output_files
+    std::vector<std::pair<std::string, std::string>> overrides; // Start of a parameter's description and its new value
+
+    JobDescription();
+    explicit JobDescription(const std::string &filePath);
+};
+
+// Thrown by a job that stopped early on SIGINT, after writing its output so far
+struct JobInterrupted : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct JobServer {
+    using JobRunner = std::function<void(const InputData &, const LoggerPtr &)>;
+
+    std::filesystem::path spoolDirectory; // Folder polled for .job files
+    int numWorkers;                       // Number of worker processes running jobs side by side
+    int pollInterval = 1;                 // Seconds between looking for new jobs when idle
+    JobRunner runJob;                     // Runs a simulation in the current directory
+    LoggerPtr logger;
+
+    JobServer(const std::string &spoolDirectoryArg, const int &numWorkersArg, const JobRunner &runJobArg, const LoggerPtr &loggerArg);
+
+    void run(const std::atomic<bool> &stopFlag);
+    pid_t startWorker(const int &workerID, const std::atomic<bool> &stopFlag);
+    void runWorker(const int &workerID, const std::atomic<bool> &stopFlag);
+    std::optional<std::filesystem::path> claimJob() const;
+    void runClaimedJob(const std::filesystem::path &jobPath, const int &workerID);
+
+    static std::string applyOverrides(const std::string &parameters, const std::vector<std::pair<std::string, std::string>> &overrides);
+};
+
+#endif // JOB_SERVER_H
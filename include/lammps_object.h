@@ -32,26 +32,52 @@ struct LammpsObject {
     Network networkA;
     Network networkB;
 
-    void *handle;
+    void *handle = nullptr;
     int version;
     int natoms = 0;
     int nbonds = 0;
     int nangles = 0;
     double *bonds = nullptr;
+    bool isAtomEnergyComputeDefined = false;
+    bool isVerifyingEdits = true; // Check the bond or angle count before and after every edit
+    std::string potentialCommands; // Commands setting up the potential, reissued to change the style suffix
+    int atomOffset = 0;            // Added to the atom IDs of this replica when several replicas share the instance
+    std::vector<int> atomIDs;      // IDs of the atoms of this replica, empty if the object holds every atom
+    std::vector<char> isFrozenAtom;          // Whether each atom is outside the active region, empty if no atom is frozen
+    std::vector<double> frozenAtomEnergies;  // Energy of each atom from the removed interactions among frozen atoms
+    double frozenEnergy = 0.0;               // Total energy of the removed interactions among frozen atoms
 
     std::vector<int> angleHelper = std::vector<int>(6);
 
     LoggerPtr logger;
 
+    static void *spareHandle; // Instance kept open by release, cleared and reused by the next object loaded from files
+
     LammpsObject();
     explicit LammpsObject(const LoggerPtr &loggerArg);
-
-    void minimiseNetwork();
+    LammpsObject(const Network &baseNetwork, const std::string &potential, const LoggerPtr &loggerArg);
+    LammpsObject(const Network &baseNetwork, const std::string &potential, const int &numReplicas, const LoggerPtr &loggerArg);
+    LammpsObject getReplica(const int &replica, const int &numReplicas) const;
+    void close();
+    void release();
+
+    int minimiseNetwork();
+    void setMinimiser(const std::string &minStyle, const double &energyTolerance);
+    void setNumThreads(const int &numThreads);
+    bool hasOpenMP() const;
+    void rebuildTopology(const std::vector<int> &topologyBonds, const std::vector<int> &topologyAngles, const bool &isFrozenSkipped = true);
+    bool isFrozen(const std::vector<int> &atoms) const;
     double getPotentialEnergy();
+    double evaluatePotentialEnergy();
+    void getAtomEnergies(std::vector<double> &atomEnergies);
 
     std::vector<double> getCoords(const int &dim) const;
+    void getCoords(std::vector<double> &coords, const int &dim) const;
     void setCoords(std::vector<double> &newCoords, int dim);
     void setAtomCoords(const int &atomID, const std::vector<double> &newCoords, const int &dim);
+    int getLocalIndex(const int &atomID) const;
+    void setAtomSortInterval(const int &interval);
+    void freezeInactiveAtoms(const std::vector<int> &activeNodeIDs);
 
     void breakBond(const int &atom1, const int &atom2, const int &type);
     void formBond(const int &atom1, const int &atom2, const int &type);
@@ -65,6 +91,7 @@ struct LammpsObject {
                         const std::vector<double> &rotatedCoord1, const std::vector<double> &rotatedCoord2);
     void revertGraphene(const std::vector<int> &bondBreaks, const std::vector<int> &bondMakes,
                         const std::vector<int> &angleBreaks, const std::vector<int> &angleMakes);
+    std::vector<int> getBonds() const;
     std::vector<int> getAngles() const;
 
 
@@ -2,17 +2,25 @@
 
 #ifndef NL_LINKED_NETWORK_H
 #define NL_LINKED_NETWORK_H
+#include "frame_renderer.h"
+#include "half_edge_mesh.h"
 #include "input_data.h"
 #include "lammps_object.h"
 #include "metropolis.h"
 #include "network.h"
+#include "relaxation_templates.h"
+#include "switch_heatmap.h"
+#include "topology_cache.h"
+#include "wang_landau.h"
 #include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <omp.h>
+#include <optional>
 #include <random>
 #include <spdlog/spdlog.h>
 #include <sstream>
@@ -26,6 +34,43 @@ enum class Direction {
     ANTICLOCKWISE
 };
 
+enum class ProposalResult {
+    FAILED_ANGLE_CHECK,
+    FAILED_BOND_LENGTH_CHECK,
+    RELAXED
+};
+
+// Outcome of evaluating a proposal, valid until the next accepted move
+struct ProposalOutcome {
+    ProposalResult result; // Which check the proposal failed, or RELAXED if it reached the Metropolis condition
+    double finalEnergy;    // Relaxed energy of the proposal if result is RELAXED
+    double proposalRatio;  // Hastings ratio of the proposal if result is RELAXED
+};
+
+// A switch move and everything needed to perform and revert it
+struct SwitchMove {
+    int baseNode1;
+    int baseNode2;
+    int ringNode1;
+    int ringNode2;
+    std::vector<int> bondBreaks;
+    std::vector<int> bondMakes;
+    std::vector<int> angleBreaks;
+    std::vector<int> angleMakes;
+    std::vector<int> ringBondBreakMake;
+    std::unordered_set<int> involvedNodes;
+    std::vector<int> shellNodes; // baseNode1 to baseNode14 in genSwitchOperations, in order
+    int templateCase = 0;        // Relaxation template case from the sizes of the rings losing a node
+    std::vector<double> rotatedCoord1;
+    std::vector<double> rotatedCoord2;
+    std::vector<Node> initialInvolvedNodesA;
+    std::vector<Node> initialInvolvedNodesB;
+
+    int epoch = 0;                         // Value of acceptanceEpoch when the move was found
+    std::unordered_set<int> examinedNodes; // Base nodes read while finding the move, only recorded when pipelining
+    std::unordered_set<int> examinedRings; // Ring nodes read while finding the move, only recorded when pipelining
+};
+
 struct LinkedNetwork {
     // Data members
 
@@ -34,6 +79,7 @@ struct LinkedNetwork {
     int maxRingSize;  // Maximum coordination number of ring network
 
     Network networkA; // Base network
+    HalfEdgeMesh mesh; // Bonds of networkA with the rings of networkB as faces, switched alongside them
 
     std::vector<double> dimensions;   // Periodic boundary of network, xlo = ylo = 0, so dimensions = [xhi, yhi]
     std::vector<double> centreCoords; // Centre of network = [xhi / 2, yhi / 2]
@@ -42,52 +88,135 @@ struct LinkedNetwork {
     double energy;              // The current energy of the system
 
     std::vector<double> currentCoords;
+    std::vector<double> relaxedCoords; // Coordinates of the trial network, reused between moves
 
     bool isOpenMPIEnabled;          // Whether to use MPI
-    SelectionType selectionType;    // Either 'weighted' or 'random'
+    SelectionType selectionType;    // Either 'weighted', 'strain' or 'random'
     std::mt19937 randomNumGen;      // mersenne twister random number generator
     Metropolis metropolisCondition; // monte carlo metropolis condition
     double weightedDecay;           // decay factor for weighted monte carlo
     double maximumBondLength;       // Maximum bond length
     double maximumAngle;            // Maximum angle between atoms
     bool writeMovie;                // Write movie file or not
+    std::unique_ptr<FrameRenderer> frameRenderer; // Draws movie frames in process, null unless the native renderer is used
 
-    std::unordered_map<int, int> fixedRings; // IDs of the fixed rings
-    std::unordered_set<int> fixedNodes;      // IDs of the fixed nodes
+    std::vector<int> fixedRingSizes; // Size of each ring when it was fixed, 0 if the ring is not fixed
+    std::vector<char> isFixedNode;   // Whether each base node is a member of a fixed ring
+    std::vector<char> isActiveNode;  // Whether switches may move each base node, empty if every node is active
+    std::vector<int> activeNodes;    // IDs of the active base nodes, empty if every node is active
 
     int numSwitches = 0;            // Number of switches performed
     int numAcceptedSwitches = 0;    // Number of switches accepted
     int failedBondLengthChecks = 0; // Number of failed bond length checks
     int failedAngleChecks = 0;      // Number of failed angle checks
     int failedEnergyChecks = 0;     // Number of failed energy checks
+    int numHexagons = -1;           // Number of six-membered rings, counted when first needed by Wang-Landau sampling
+
+    TopologyCache topologyCache;           // Relaxed energies and coordinates of previously visited topologies
+    uint64_t topologyHash = 0;             // Zobrist hash of the bonds in the base network
+    bool skipRelaxationOnCacheHit = false; // Use cached geometry as is rather than as a starting point for minimisation
+
+    bool reuseProposalOutcomes = false;                           // Reuse outcomes of proposals repeated between acceptances
+    int acceptanceEpoch = 0;                                      // Number of accepted moves, invalidates prepared moves
+    int numReusedProposals = 0;                                   // Number of proposals not re-evaluated
+    std::unordered_map<uint64_t, ProposalOutcome> proposalOutcomes; // Outcomes since the last acceptance keyed by getProposalKey
+
+    bool pipelineProposals = false;               // Find the next move on a helper thread while LAMMPS minimises
+    std::future<SwitchMove> nextSwitchMove;       // Move being found on the helper thread
+    std::optional<SwitchMove> preparedSwitchMove; // Move found on the helper thread waiting to be performed
+    std::mt19937 preparedRandomNumGen;            // State of randomNumGen before the prepared move was found
+    int numDiscardedProposals = 0;                // Number of prepared moves invalidated by an accepted move
+
+    bool isLeanMemory = false; // Trade speed for memory on very large networks
+
+    RelaxationTemplates relaxationTemplates; // Displacements of the shell nodes learned from previous relaxations
+
+    double topologyOnlyTemperature;     // Temperature at and above which switches are made to the BSS networks only
+    int topologyOnlyRelaxInterval;      // Topology-only switches between LAMMPS resynchronisations, 0 to wait for a normal move
+    bool isLammpsOutOfSync = false;     // Topology-only switches have been made since LAMMPS was last synchronised
+    int numTopologyOnlySwitches = 0;    // Number of topology-only switches attempted
+    int numSwitchesSinceLammpsSync = 0; // Topology-only switches accepted since LAMMPS was last synchronised
+
+    int switchBatchSize = 1;                 // Separated switches applied and relaxed in a single minimisation
+    int batchRegionRadius = 0;               // Bonds beyond the second shell of a switch that belong to its region
+    int numBatchRelaxations = 0;             // Number of minimisations made for batches of switches
+    std::vector<double> currentAtomEnergies; // Per-atom energies of the current network, before a batch or for strain weights
+    std::vector<double> relaxedAtomEnergies; // Per-atom energies after minimising a batch, reused between batches
+
+    int topologyAuditInterval = 0; // Steps between full audits of the LAMMPS topology, 0 if every edit is verified
+    int lastCleanAuditStep = 0;    // Value of numSwitches at the last audit that found no differences
+
+    double ringAreaTolerance = 0.0;      // Distance a node moves before its rings are remeasured
+    std::vector<double> ringAreas;       // Cached area of every ring, empty until first measured
+    std::vector<double> ringPerimeters;  // Cached perimeter of every ring
+    std::vector<double> ringAreaCoords;  // Coordinates of the base nodes when their rings were last measured
+    std::vector<char> isRingAreaStale;   // Rings whose nodes have changed since they were last measured
+
+    SwitchHeatmap heatmap; // Proposals, outcomes and relaxation times over a grid of the box, disabled if the grid size is 0
+
+    std::vector<int> baseNodeOrder; // Original ID of every base node after renumbering, empty if not renumbered
+    std::vector<int> ringNodeOrder; // Original ID of every ring node after renumbering, empty if not renumbered
 
     LoggerPtr logger; // Logger
     std::vector<double> weights;
+    std::discrete_distribution<> nodeDistribution; // Distribution over weights, rebuilt by updateWeights
+    std::vector<double> proposedWeights;           // Strain weights of the trial network, for the Hastings ratio and kept on acceptance
 
     // Constructors
     LinkedNetwork();
     LinkedNetwork(const int &numRing, const LoggerPtr &logger);
     LinkedNetwork(const InputData &inputData, const LoggerPtr &logger);
+    LinkedNetwork(const InputData &inputData, const Network *baseNetwork, const std::string &potential, const LoggerPtr &logger);
+    LinkedNetwork(const LinkedNetwork &source, const LammpsObject &replicaObject);
 
     void findFixedRings(const std::string &flePath);
     void findFixedNodes();
+    void findActiveNodes(const ActiveRegion &activeRegion, const int &numShells, const double &radius);
+    bool isNodeActive(const int &nodeID) const;
+    std::unordered_set<int> getUnfixedNodes(const std::unordered_set<int> &nodeIDs) const;
+    void renumberNodes(const NodeOrdering &nodeOrdering);
+    void autotuneLammps(const int &numMoves, const double &energyTolerance);
+    void getOriginalNetworks(Network &baseNetwork, Network &ringNetwork) const;
 
     void rescale(double scaleFactor);
     void updateWeights();
+    void getStrainWeights(const std::vector<double> &atomEnergies, std::vector<double> &nodeWeights) const;
+    double getBondProposalProbability(const int &baseNode1, const int &baseNode2, const std::vector<double> &nodeWeights) const;
+    int pickRandomNode();
     std::tuple<int, int, int, int> pickRandomConnection();
     int assignValues(int randNodeCoordination, int randNodeConnectionCoordination) const;
 
     int findCommonConnection(const int &baseNode, const int &ringNode, const int &excludeNode) const;
     int findCommonRing(const int &baseNode1, const int &baseNode2, const int &excludeNode) const;
 
+    SwitchMove findSwitchMove();
+    SwitchMove takeSwitchMove();
+    void prepareNextSwitchMove();
+    void collectNextSwitchMove();
+    void validatePreparedSwitchMove(const SwitchMove &acceptedMove);
+
     void monteCarloSwitchMoveLAMMPS(const double &temperature);
-    void rejectMove(const std::vector<Node> &initialInvolvedNodesA, const std::vector<Node> &initialInvolvedNodesB,
-                    const std::vector<int> &bondBreaks, const std::vector<int> &bondMakes,
-                    const std::vector<int> &angleBreaks, const std::vector<int> &angleMakes);
+    void monteCarloBatchSwitchMove(const double &temperature);
+    int countHexagons() const;
+    std::vector<double> getRingSizeFractions() const;
+    void wangLandauSwitchMove(WangLandau &wangLandau, const double &temperature);
+    void usePackedLammps(const LammpsObject &replicaObject);
+    SwitchMove startPackedSwitchMove();
+    void finishPackedSwitchMove(const SwitchMove &move, const double &finalEnergy, const double &temperature);
+    std::unordered_set<int> getSwitchRegion(const SwitchMove &move) const;
+    void topologySwitchMove();
+    void embedSwitch(const SwitchMove &move);
+    void syncLammpsNetwork();
+    void auditLammpsTopology();
+    void rejectMove(const SwitchMove &move);
 
     bool checkConsistency();
+    void logMemoryUsage() const;
 
-    void write() const;
+    void write(const std::string &directory) const;
+    void writeMovieFrame();
+    void stopMovie();
+    void writeLammpsData();
 
     void pushCoords(const std::vector<double> &coords);
     void showCoords(const std::vector<double> &coords) const;
@@ -96,10 +225,21 @@ struct LinkedNetwork {
     bool genSwitchOperations(int baseNode1, int baseNode2, int ringNode1, int ringNode2,
                              std::vector<int> &bondBreaks, std::vector<int> &bondMakes,
                              std::vector<int> &angleBreaks, std::vector<int> &angleMakes,
-                             std::vector<int> &ringBondBreakMake, std::unordered_set<int> &convexCheckIDs);
+                             std::vector<int> &ringBondBreakMake, std::unordered_set<int> &convexCheckIDs,
+                             std::vector<int> &shellNodes);
+
+    uint64_t getProposalKey(const int &baseNode1, const int &baseNode2, const int &ringNode1, const int &ringNode2) const;
+    uint64_t computeTopologyHash() const;
+    uint64_t getSwitchHashDelta(const std::vector<int> &bondBreaks) const;
+    double relaxNetwork(const uint64_t &hash, std::vector<double> &coords, int &minimiserIterations);
+    int getHeatmapCell(const SwitchMove &move) const;
+    std::tuple<std::vector<double>, std::vector<double>> getBondFrame(const SwitchMove &move) const;
+    bool applyRelaxationTemplate(const SwitchMove &move);
+    void learnRelaxationTemplate(const SwitchMove &move, const std::vector<double> &coords);
 
     void switchNetMCGraphene(const std::vector<int> &bondBreaks, const std::vector<int> &ringBondBreakMake);
-    void revertNetMCGraphene(const std::vector<Node> &initialInvolvedNodesA, const std::vector<Node> &initialInvolvedNodesB);
+    void revertNetMCGraphene(const std::vector<int> &bondBreaks, const std::vector<Node> &initialInvolvedNodesA,
+                             const std::vector<Node> &initialInvolvedNodesB);
 
     std::tuple<std::vector<double>, std::vector<double>> rotateBond(const int &atomID1, const int &atomID2,
                                                                     const Direction &direct) const;
@@ -117,7 +257,10 @@ struct LinkedNetwork {
     bool checkBondLengths(const std::unordered_set<int> &nodeIDs, const std::vector<double> &coords) const;
 
     std::map<int, double> getRingSizes() const;
-    std::vector<double> getRingAreas() const;
+    void refreshRingAreas();
+    const std::vector<double> &getRingAreas();
+    const std::vector<double> &getRingPerimeters();
+    std::map<int, double> getMeanRingAreas();
 };
 
 #endif // NL_LINKED_NETWORK_H
@@ -0,0 +1,23 @@
+// Fixed size array of floats in a memory mapped file, for cold data the operating system can page out
+#ifndef MAPPED_ARRAY_H
+#define MAPPED_ARRAY_H
+
+#include <cstddef>
+#include <string>
+
+struct MappedArray {
+    float *data = nullptr;
+    size_t size = 0;
+
+    MappedArray();
+    MappedArray(const std::string &directory, const size_t &sizeArg);
+    MappedArray(MappedArray &&other) noexcept;
+    MappedArray &operator=(MappedArray &&other) noexcept;
+    MappedArray(const MappedArray &) = delete;
+    MappedArray &operator=(const MappedArray &) = delete;
+    ~MappedArray();
+
+    size_t getNumBytes() const;
+};
+
+#endif // MAPPED_ARRAY_H
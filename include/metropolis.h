@@ -1,6 +1,7 @@
 #ifndef METROPOLIS_H
 #define METROPOLIS_H
 
+#include <cmath>
 #include <iostream>
 #include <random>
 
@@ -11,7 +12,8 @@ struct Metropolis {
     Metropolis();
     explicit Metropolis(const int &seed);
 
-    bool acceptanceCriterion(const double &finalEnergy, const double &initialEnergy, const double &temperature);
+    bool acceptanceCriterion(const double &finalEnergy, const double &initialEnergy, const double &temperature,
+                             const double &proposalRatio = 1.0);
 };
 
 #endif // METROPOLIS_H
@@ -0,0 +1,88 @@
+/*
+ * C interface to the bond switch simulator, for driving simulations in-process without reading and writing
+ * ./input_files and ./output_files. Link against libnetmc.
+ *
+ * A simulation is created from the contents of a bss_parameters.txt file, a base network and the contents of
+ * a lammps_potential.txt file. Its ring network is derived from the base network. Functions returning int
+ * return 0 on success and -1 on failure, in which case netmc_get_error describes what went wrong. Every function
+ * accepts a NULL simulation and fails, and no exception ever crosses the interface.
+ *
+ * NETMC_ABI_VERSION is increased whenever a function signature changes. Fields are only ever appended to
+ * netmc_statistics.
+ */
+#ifndef NETMC_H
+#define NETMC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NETMC_ABI_VERSION 1
+
+typedef struct netmc_simulation netmc_simulation;
+
+typedef struct netmc_statistics {
+    int num_switches;              /* Number of attempted switches */
+    int num_accepted_switches;     /* Number of accepted switches */
+    int failed_angle_checks;       /* Number of switches rejected by the angle check */
+    int failed_bond_length_checks; /* Number of switches rejected by the bond length check */
+    int failed_energy_checks;      /* Number of switches rejected by the Metropolis condition */
+    double energy;                 /* Potential energy of the network */
+    double entropy;                /* Entropy of the ring size distribution */
+    double pearsons_coeff;         /* Pearson's coefficient of the ring network */
+    double aboav_weaire;           /* Aboav-Weaire parameter of the ring network */
+    double mean_ring_size;         /* Mean ring size */
+} netmc_statistics;
+
+/* Version of the interface the library was built with, to compare with NETMC_ABI_VERSION */
+int netmc_abi_version(void);
+
+/*
+ * Create a simulation, or return NULL and write the reason to error if it cannot be created
+ * parameters: contents of a bss_parameters.txt file
+ * num_nodes: number of nodes in the base network
+ * coords: coordinates of the nodes, 2 * num_nodes values
+ * connection_offsets: the neighbours of node i are connections[connection_offsets[i]] up to
+ *                     connections[connection_offsets[i + 1]], num_nodes + 1 values
+ * connections: zero-indexed IDs of the neighbours of every node
+ * xhi, yhi: periodic boundary of the network, xlo = ylo = 0
+ * potential: LAMMPS commands setting up the potential, like the contents of lammps_potential.txt
+ * error: buffer of error_size characters for the reason creation failed, may be NULL
+ */
+netmc_simulation *netmc_create(const char *parameters, int num_nodes, const double *coords,
+                               const int *connection_offsets, const int *connections, double xhi, double yhi,
+                               const char *potential, char *error, int error_size);
+
+/* Free a simulation and its LAMMPS instance */
+void netmc_destroy(netmc_simulation *simulation);
+
+/* Attempt num_steps switch moves at a temperature in energy units, not 10^x as in bss_parameters.txt */
+int netmc_run(netmc_simulation *simulation, int num_steps, double temperature);
+
+/* Number of nodes in the base network and rings in the ring network, -1 on failure */
+int netmc_get_num_nodes(const netmc_simulation *simulation);
+int netmc_get_num_rings(const netmc_simulation *simulation);
+
+int netmc_get_statistics(netmc_simulation *simulation, netmc_statistics *statistics);
+
+/* Copy the coordinates of the base nodes into coords, which holds size values and needs 2 * num_nodes */
+int netmc_get_coords(const netmc_simulation *simulation, double *coords, int size);
+
+/*
+ * Copy the connections of the base network in the same layout as netmc_create. connection_offsets needs
+ * num_nodes + 1 values and connections holds size values. Switches keep the number of connections, so
+ * arrays the size of those passed to netmc_create are always big enough.
+ */
+int netmc_get_connections(const netmc_simulation *simulation, int *connection_offsets, int *connections, int size);
+
+/* Copy the size of each ring into ring_sizes, which holds size values and needs num_rings */
+int netmc_get_ring_sizes(const netmc_simulation *simulation, int *ring_sizes, int size);
+
+/* Description of the last failure, empty if nothing has failed */
+const char *netmc_get_error(const netmc_simulation *simulation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NETMC_H */
@@ -39,6 +39,8 @@ struct Network {
     // Constructors
     Network();
     Network(const NetworkType networkType, const LoggerPtr &logger); // construct by loading from files
+    Network(const std::string &directory, const NetworkType networkType, const bool &readDualConnections, const LoggerPtr &logger);
+    Network(const std::vector<double> &coords, const std::vector<std::vector<int>> &connections, const std::vector<double> &dimensionsArg);
     void readInfo(const std::string &filePath);
     void readCoords(const std::string &filePath);
     void readConnections(const std::string &filePath, const bool &isDual);
@@ -57,13 +59,18 @@ struct Network {
     double getAboavWeaire() const;
     double getAverageCoordination(const int &power) const;
 
+    std::vector<double> getRingAreas(const Network &baseNetwork) const;
+    std::vector<double> getBondLengths() const;
+    std::vector<double> getBondAngles() const;
+    void getBondsAndAngles(std::vector<int> &bonds, std::vector<int> &angles) const;
+
     // Write functions
     void writeInfo(std::ofstream &infoFile) const;
     void writeCoords(std::ofstream &crdFile) const;
     void writeConnections(std::ofstream &cnxFile, const std::vector<std::vector<int>> &cnxs) const;
     std::vector<std::vector<int>> getConnections() const;
     std::vector<std::vector<int>> getDualConnections() const;
-    void write() const;
+    void write(const std::string &directory) const;
 
     int getMaxConnections() const;
     int getMaxConnections(const std::unordered_set<int> &fixedNodes) const;
@@ -76,7 +83,14 @@ struct Network {
     int getMinDualConnections(const std::unordered_set<int> &fixedNodes) const;
 
     std::vector<double> getCoords();
+    void shrinkToFit();
+    size_t getMemoryUsage() const;
     void centreRings(const Network &baseNetwork);
+    void centreRing(const int &ringNode, const Network &baseNetwork);
+    Network deriveRingNetwork();
+    std::vector<int> getHilbertOrder() const;
+    std::vector<int> getCuthillMcKeeOrder() const;
+    void renumber(const std::vector<int> &order, const std::vector<int> &dualOrder);
 
     int findNumberOfUniqueDualNodes();
     void display(const LoggerPtr &logger) const;
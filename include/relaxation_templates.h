@@ -0,0 +1,40 @@
+// Displacement templates learned from completed relaxations, used to warm-start the minimiser after a switch
+#ifndef RELAXATION_TEMPLATES_H
+#define RELAXATION_TEMPLATES_H
+
+#include <array>
+#include <vector>
+
+struct RelaxationTemplates {
+    static constexpr int NUM_CASES = 9;        // 4, 5 or 6+ membered ringNode1 for each of 4, 5 or 6+ membered ringNode2
+    static constexpr int NUM_SHELL_NODES = 14; // baseNode1 to baseNode14 in genSwitchOperations
+    static constexpr int MIN_SAMPLES = 5;      // Relaxations needed before a template is applied
+    static constexpr int MAX_SAMPLES = 100;    // Beyond this, older relaxations are forgotten exponentially
+
+    struct Template {
+        int numSamples = 0;
+        // Mean displacement of each shell node from its pre-switch position to its relaxed position,
+        // in the frame of the switched bond, as a 1D vector of pairs
+        std::vector<double> displacements = std::vector<double>(2 * NUM_SHELL_NODES, 0.0);
+    };
+
+    bool isEnabled = false;
+    std::array<Template, NUM_CASES> templates;
+
+    int numWithTemplate = 0;            // Minimisations started from a template
+    long iterationsWithTemplate = 0;    // Minimiser iterations of minimisations started from a template
+    int numWithoutTemplate = 0;         // Minimisations started from the rotated bond only
+    long iterationsWithoutTemplate = 0; // Minimiser iterations of minimisations started from the rotated bond only
+
+    RelaxationTemplates();
+    explicit RelaxationTemplates(const bool &isEnabledArg);
+
+    static int getCase(const int &ringSize1, const int &ringSize2);
+
+    const Template *find(const int &switchCase) const;
+    void learn(const int &switchCase, const std::vector<double> &displacements);
+    void recordIterations(const bool &isTemplateApplied, const int &iterations);
+    double getMeanIterations(const bool &isTemplateApplied) const;
+};
+
+#endif // RELAXATION_TEMPLATES_H
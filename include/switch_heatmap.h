@@ -0,0 +1,40 @@
+// Counts of switch proposals, their outcomes and their relaxation times over a coarse grid of the periodic box
+#ifndef SWITCH_HEATMAP_H
+#define SWITCH_HEATMAP_H
+
+#include "output_file.h"
+#include <vector>
+
+enum class SwitchOutcome {
+    ACCEPTED,
+    FAILED_ANGLE_CHECK,
+    FAILED_BOND_LENGTH_CHECK,
+    FAILED_ENERGY_CHECK
+};
+
+struct SwitchHeatmap {
+    int gridSize = 0;               // Number of cells along each side of the box, 0 if disabled
+    std::vector<double> dimensions; // Periodic boundary of the network
+
+    // Counts in every cell, row by row from the lowest y, for the switches whose bond midpoint lies in the cell
+    std::vector<long long> proposals;
+    std::vector<long long> accepted;
+    std::vector<long long> failedAngleChecks;
+    std::vector<long long> failedBondLengthChecks;
+    std::vector<long long> failedEnergyChecks;
+    std::vector<long long> relaxations;   // Proposals that were minimised rather than reused or embedded
+    std::vector<double> relaxationTimes;  // Total time spent minimising the proposals of every cell (ms)
+
+    SwitchHeatmap();
+    SwitchHeatmap(const int &gridSizeArg, const std::vector<double> &dimensionsArg);
+
+    bool isEnabled() const;
+    int getCell(const std::vector<double> &coord1, const std::vector<double> &coord2) const;
+    void record(const int &cell, const SwitchOutcome &outcome);
+    void recordRelaxation(const int &cell, const double &relaxationTime);
+    void add(const SwitchHeatmap &other);
+
+    void write(OutputFile &file, const int &step) const;
+};
+
+#endif // SWITCH_HEATMAP_H
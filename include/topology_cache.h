@@ -0,0 +1,46 @@
+// Bounded least recently used cache of relaxed networks keyed by a Zobrist hash of the base network bonds
+#ifndef TOPOLOGY_CACHE_H
+#define TOPOLOGY_CACHE_H
+
+#include "mapped_array.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct TopologyCache {
+    struct Entry {
+        double energy; // Relaxed potential energy of the network
+        size_t slot;   // Index of the relaxed coordinates in the coordinate pool
+    };
+
+    size_t capacity = 0;   // Maximum number of entries, 0 disables the cache
+    bool isMapped = false; // Store coordinates in a memory mapped file rather than on the heap
+    size_t entrySize = 0;  // Number of coordinates per entry, set by the first insertion
+    int hits = 0;          // Number of successful lookups
+    int misses = 0;        // Number of failed lookups
+
+    // Most recently used entries are at the front of the list
+    std::list<std::pair<uint64_t, Entry>> entries;
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, Entry>>::iterator> lookup;
+
+    // Relaxed coordinates of every entry in single precision, as 1D vectors of pairs
+    std::vector<float> heapCoords;
+    MappedArray mappedCoords;
+
+    TopologyCache();
+    TopologyCache(const size_t &capacityArg, const bool &isMappedArg);
+
+    static uint64_t bondKey(const int &node1, const int &node2);
+
+    bool isEnabled() const;
+    const Entry *find(const uint64_t &hash);
+    void insert(const uint64_t &hash, const double &energy, const std::vector<double> &coords);
+    const float *getCoords(const Entry &entry) const;
+    double getHitRate() const;
+    size_t getMemoryUsage() const;
+};
+
+#endif // TOPOLOGY_CACHE_H
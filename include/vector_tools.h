@@ -82,6 +82,7 @@ double getClockwiseAngle(const std::vector<double> &point);
 
 void sortCoordinatesClockwise(std::vector<std::vector<double>> &coords);
 double calculatePolygonArea(std::vector<std::vector<double>> &vertices);
+std::vector<int> invertPermutation(const std::vector<int> &permutation);
 
 #include "vector_tools.tpp"
 #endif // VEC_TOOLS_H
@@ -0,0 +1,48 @@
+// Flat histogram (Wang-Landau) estimate of the density of states in the energy or the fraction of hexagons,
+// shared by every walker
+#ifndef WANG_LANDAU_H
+#define WANG_LANDAU_H
+
+#include "input_data.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct WangLandau {
+    OrderParameter orderParameter = OrderParameter::ENERGY;
+    double referenceEnergy = 0.0; // Energies are binned relative to this, the energy of the starting network
+    double minimum = 0.0;         // Lower edge of the first bin
+    double maximum = 0.0;         // Upper edge of the last bin
+    double binWidth = 0.0;
+    double flatness = 0.8;          // Fewest visits to any visited bin as a fraction of the mean for the histogram to be flat
+    double lnModification = 1.0;    // Added to ln g of every visited bin, halved whenever the histogram is flat
+    double finalModification = 0.0; // Sampling has converged once lnModification falls below this
+    int numIterations = 0;          // Number of times the histogram has been flat
+    int minRingSize = 0;
+
+    std::vector<double> lnDensity;      // Natural logarithm of the density of states in every bin
+    std::vector<long long> histogram;   // Visits to every bin since lnModification last changed
+    std::vector<bool> isVisited;        // Bins visited at any time, only these have to be flat
+    std::vector<long long> numVisits;   // Visits to every bin over the whole run
+    std::vector<std::vector<double>> ringSizeSums; // Sum over the visits to every bin of the fraction of rings of each size
+
+    std::mutex mutex;
+    LoggerPtr logger;
+
+    WangLandau(const OrderParameter &orderParameterArg, const double &referenceEnergyArg, const double &minimumArg,
+               const double &maximumArg, const int &numBins, const double &flatnessArg, const double &finalModificationArg,
+               const int &minRingSizeArg, const int &maxRingSize, const LoggerPtr &loggerArg);
+
+    double getOrderParameter(const double &energy, const int &numHexagons, const int &numRings) const;
+    int getBin(const double &value) const;
+    double getBinCentre(const int &bin) const;
+    bool acceptanceCriterion(const double &initialValue, const double &finalValue, const double &energyChange,
+                             const double &temperature, const double &randomNumber);
+    void visit(const double &value, const std::vector<double> &ringSizeFractions);
+    bool isFlat() const;
+    bool isConverged();
+
+    void write(const std::string &directory, const std::vector<double> &temperatures) const;
+};
+
+#endif // WANG_LANDAU_H
@@ -0,0 +1,118 @@
+#include "equilibration_detector.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * @brief Default constructor for a disabled detector
+ */
+EquilibrationDetector::EquilibrationDetector() = default;
+
+/**
+ * @brief Construct a detector with no samples
+ * @param isEnabledArg Test for equilibration as samples are added
+ * @param minEffectiveSamplesArg Effective samples needed in every observable after equilibration
+ * @param toleranceArg Largest allowed drift in standard errors between the start and end of the kept samples
+ */
+EquilibrationDetector::EquilibrationDetector(const bool &isEnabledArg, const int &minEffectiveSamplesArg, const double &toleranceArg)
+    : isEnabled(isEnabledArg), minEffectiveSamples(minEffectiveSamplesArg), tolerance(toleranceArg) {
+}
+
+/**
+ * @brief Record the value of every observable at a step
+ * @param step The step the values were sampled at
+ * @param values The value of each observable, in the same order for every sample
+ * @throw std::invalid_argument if the number of values differs from earlier samples
+ */
+void EquilibrationDetector::addSample(const int &step, const std::vector<double> &values) {
+    if (observables.empty()) {
+        observables.resize(values.size());
+    } else if (values.size() != observables.size()) {
+        throw std::invalid_argument("Number of observables changed between samples");
+    }
+    steps.push_back(step);
+    for (size_t i = 0; i < values.size(); ++i) {
+        observables[i].push_back(values[i]);
+    }
+}
+
+/**
+ * @brief Test whether the stage is equilibrated. The first half of the samples is discarded as burn in, and the
+ * rest is equilibrated if no observable drifts by more than tolerance standard errors between the first and last
+ * thirds of it, and every observable has at least minEffectiveSamples effective samples. The test is repeated each
+ * time the number of samples grows by a tenth, so its cost stays linear in the number of samples.
+ * @return true once the stage has been found to be equilibrated
+ */
+bool EquilibrationDetector::check() {
+    size_t numSamples = steps.size();
+    if (!isEnabled || isEquilibrated || numSamples < nextCheck) {
+        return isEquilibrated;
+    }
+    nextCheck = std::max(numSamples + 1, numSamples + numSamples / 10);
+    size_t start = numSamples / 2;
+    size_t numKept = numSamples - start;
+    size_t numThird = numKept / 3;
+    if (numThird < MIN_BLOCKS) {
+        return false;
+    }
+    double minEffectiveSamplesFound = std::numeric_limits<double>::max();
+    bool isDrifting = false;
+    for (const std::vector<double> &samples : observables) {
+        const double *kept = samples.data() + start;
+        minEffectiveSamplesFound = std::min(minEffectiveSamplesFound, numKept / getStatistics(kept, numKept).inefficiency);
+        SeriesStatistics first = getStatistics(kept, numThird);
+        SeriesStatistics last = getStatistics(kept + numKept - numThird, numThird);
+        double drift = std::abs(last.mean - first.mean);
+        isDrifting = isDrifting || drift > tolerance * std::hypot(first.standardError, last.standardError);
+    }
+    effectiveSamples = minEffectiveSamplesFound;
+    if (isDrifting || effectiveSamples < minEffectiveSamples) {
+        return false;
+    }
+    isEquilibrated = true;
+    equilibrationStep = steps[start];
+    return true;
+}
+
+/**
+ * @brief Get the mean and standard error of correlated samples by blocking. Neighbouring blocks are averaged
+ * until fewer than MIN_BLOCKS remain, and the largest standard error of the block means is taken as the plateau.
+ * @param values Pointer to the first sample
+ * @param numValues Number of samples
+ * @return The mean, standard error and statistical inefficiency of the samples
+ */
+EquilibrationDetector::SeriesStatistics EquilibrationDetector::getStatistics(const double *values, const size_t &numValues) {
+    SeriesStatistics statistics;
+    if (numValues == 0) {
+        return statistics;
+    }
+    std::vector<double> blocks(values, values + numValues);
+    double sum = 0.0;
+    for (const double &value : blocks) {
+        sum += value;
+    }
+    statistics.mean = sum / numValues;
+
+    double naiveError = 0.0; // Standard error if the samples were independent
+    for (int level = 0; blocks.size() >= MIN_BLOCKS; ++level) {
+        double sumSquares = 0.0;
+        for (const double &block : blocks) {
+            sumSquares += (block - statistics.mean) * (block - statistics.mean);
+        }
+        double blockError = std::sqrt(sumSquares / (blocks.size() * (blocks.size() - 1)));
+        if (level == 0) {
+            naiveError = blockError;
+        }
+        statistics.standardError = std::max(statistics.standardError, blockError);
+        // A trailing odd sample is dropped, which moves the block means slightly away from the overall mean
+        for (size_t i = 0; i < blocks.size() / 2; ++i) {
+            blocks[i] = (blocks[2 * i] + blocks[2 * i + 1]) / 2;
+        }
+        blocks.resize(blocks.size() / 2);
+    }
+    if (naiveError > 0.0) {
+        statistics.inefficiency = std::max(1.0, std::pow(statistics.standardError / naiveError, 2));
+    }
+    return statistics;
+}
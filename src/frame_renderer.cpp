@@ -0,0 +1,286 @@
+#include "frame_renderer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using Colour = std::array<uint8_t, 3>;
+
+const int FRAME_SIZE = 1024; // Pixels along the longest side of the box
+
+const Colour BACKGROUND_COLOUR = {255, 255, 255};
+const Colour BOND_COLOUR = {40, 40, 40};
+const Colour NODE_COLOUR = {0, 0, 0};
+
+/**
+ * @brief Get the fill colour of a ring, hexagons are pale and rings get warmer the larger they are
+ * @param ringSize The number of nodes in the ring
+ * @return The colour of the ring
+ */
+Colour getRingColour(const int &ringSize) {
+    static const std::vector<Colour> colours = {
+        {44, 62, 80},    // 3 or fewer
+        {142, 68, 173},  // 4
+        {52, 152, 219},  // 5
+        {236, 240, 241}, // 6
+        {243, 156, 18},  // 7
+        {231, 76, 60},   // 8
+        {146, 43, 33}};  // 9 or more
+    return colours[std::clamp(ringSize - 3, 0, static_cast<int>(colours.size()) - 1)];
+}
+
+/**
+ * @brief Wrap a displacement into the periodic box
+ * @param displacement The displacement along one axis
+ * @param dimension The length of the box along the axis
+ * @return The shortest displacement between the periodic images
+ */
+inline double minimumImage(const double &displacement, const double &dimension) {
+    return displacement - dimension * std::round(displacement / dimension);
+}
+
+/**
+ * @brief Start the worker threads that write frames
+ * @param directoryArg Folder the frames are written to, created if it does not exist
+ * @param dimensionsArg Periodic boundary of the network, xlo = ylo = 0
+ * @param isColouringRingsArg Fill rings with a colour for their size
+ * @param numThreads Number of worker threads, at least 1
+ */
+FrameRenderer::FrameRenderer(const std::string &directoryArg, const std::vector<double> &dimensionsArg,
+                             const bool &isColouringRingsArg, const int &numThreads)
+    : directory(directoryArg),
+      dimensions(dimensionsArg),
+      isColouringRings(isColouringRingsArg) {
+    std::filesystem::create_directories(directory);
+    scale = FRAME_SIZE / std::max(dimensions[0], dimensions[1]);
+    width = std::max(1, static_cast<int>(std::round(dimensions[0] * scale)));
+    height = std::max(1, static_cast<int>(std::round(dimensions[1] * scale)));
+    int numWorkers = std::max(1, numThreads);
+    maxQueuedFrames = 4 * numWorkers;
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(&FrameRenderer::work, this);
+    }
+}
+
+FrameRenderer::~FrameRenderer() {
+    stopWorkers();
+}
+
+/**
+ * @brief Copy the networks into a new frame for the workers to draw. Waits if the workers have fallen behind,
+ * so the queued copies stay bounded.
+ * @param baseNetwork The base network, whose nodes and bonds are drawn
+ * @param ringNetwork The ring network, used to colour rings by size
+ * @throw std::runtime_error if a previous frame could not be written
+ */
+void FrameRenderer::capture(const Network &baseNetwork, const Network &ringNetwork) {
+    Snapshot snapshot;
+    snapshot.frameNumber = numFrames++;
+    snapshot.nodeCoords.reserve(2 * baseNetwork.nodes.size());
+    for (const Node &node : baseNetwork.nodes) {
+        snapshot.nodeCoords.insert(snapshot.nodeCoords.end(), node.crd.begin(), node.crd.end());
+        for (const int &neighbour : node.netConnections) {
+            if (neighbour < node.id) {
+                continue;
+            }
+            snapshot.bonds.push_back(node.id);
+            snapshot.bonds.push_back(neighbour);
+            if (!isColouringRings) {
+                continue;
+            }
+            // The rings either side of a bond are the two rings both of its nodes belong to
+            std::array<int, 2> rings = {-1, -1};
+            int numRings = 0;
+            for (const int &ring : node.dualConnections) {
+                const std::vector<int> &neighbourRings = baseNetwork.nodes[neighbour].dualConnections;
+                if (numRings < 2 && std::find(neighbourRings.begin(), neighbourRings.end(), ring) != neighbourRings.end()) {
+                    rings[numRings++] = ring;
+                }
+            }
+            snapshot.bondRings.insert(snapshot.bondRings.end(), rings.begin(), rings.end());
+        }
+    }
+    if (isColouringRings) {
+        snapshot.ringCoords.reserve(2 * ringNetwork.nodes.size());
+        snapshot.ringSizes.reserve(ringNetwork.nodes.size());
+        for (const Node &ring : ringNetwork.nodes) {
+            snapshot.ringCoords.insert(snapshot.ringCoords.end(), ring.crd.begin(), ring.crd.end());
+            snapshot.ringSizes.push_back(static_cast<int>(ring.netConnections.size()));
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [this] { return queue.size() < maxQueuedFrames || !error.empty(); });
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+    queue.push_back(std::move(snapshot));
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+/**
+ * @brief Wait for every captured frame to be written and stop the workers
+ * @throw std::runtime_error if any frame could not be written
+ */
+void FrameRenderer::finish() {
+    stopWorkers();
+    if (!error.empty()) {
+        throw std::runtime_error(error);
+    }
+}
+
+/**
+ * @brief Let the workers draw the frames left in the queue and wait for them to stop
+ */
+void FrameRenderer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        isStopping = true;
+    }
+    queueChanged.notify_all();
+    for (std::thread &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+/**
+ * @brief Draw queued frames until the renderer is stopped and the queue is empty
+ */
+void FrameRenderer::work() {
+    while (true) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueChanged.wait(lock, [this] { return !queue.empty() || isStopping; });
+        if (queue.empty()) {
+            return;
+        }
+        Snapshot snapshot = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        queueChanged.notify_all();
+        try {
+            render(snapshot);
+        } catch (const std::exception &e) {
+            std::lock_guard<std::mutex> errorLock(queueMutex);
+            if (error.empty()) {
+                error = e.what();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draw a frame and write it as a binary PPM image. Rings are filled as triangles from their centre to
+ * each of their bonds, so the order of their nodes is not needed. Everything is drawn with the minimum image
+ * convention and wraps around the edges of the frame.
+ * @param snapshot The frame to draw
+ * @throw std::runtime_error if the frame cannot be written
+ */
+void FrameRenderer::render(const Snapshot &snapshot) const {
+    std::vector<uint8_t> pixels(3 * width * height);
+    for (size_t i = 0; i < pixels.size(); i += 3) {
+        std::copy(BACKGROUND_COLOUR.begin(), BACKGROUND_COLOUR.end(), pixels.begin() + i);
+    }
+    auto plot = [this, &pixels](int x, int y, const Colour &colour) {
+        x = ((x % width) + width) % width;
+        y = ((y % height) + height) % height;
+        std::copy(colour.begin(), colour.end(), pixels.begin() + 3 * (y * width + x));
+    };
+    // Pixel coordinates have y pointing down
+    auto toPixel = [this](const double &x, const double &y) {
+        return std::array<double, 2>{x * scale, (dimensions[1] - y) * scale};
+    };
+
+    if (isColouringRings) {
+        for (size_t bond = 0; bond < snapshot.bonds.size() / 2; ++bond) {
+            for (int side = 0; side < 2; ++side) {
+                int ring = snapshot.bondRings[2 * bond + side];
+                if (ring < 0) {
+                    continue;
+                }
+                double centreX = snapshot.ringCoords[2 * ring];
+                double centreY = snapshot.ringCoords[2 * ring + 1];
+                std::array<std::array<double, 2>, 3> corners;
+                corners[0] = toPixel(centreX, centreY);
+                for (int end = 0; end < 2; ++end) {
+                    int node = snapshot.bonds[2 * bond + end];
+                    corners[end + 1] = toPixel(centreX + minimumImage(snapshot.nodeCoords[2 * node] - centreX, dimensions[0]),
+                                               centreY + minimumImage(snapshot.nodeCoords[2 * node + 1] - centreY, dimensions[1]));
+                }
+                double area = (corners[1][0] - corners[0][0]) * (corners[2][1] - corners[0][1]) -
+                              (corners[2][0] - corners[0][0]) * (corners[1][1] - corners[0][1]);
+                if (area == 0.0) {
+                    continue;
+                }
+                Colour colour = getRingColour(snapshot.ringSizes[ring]);
+                int minX = static_cast<int>(std::floor(std::min({corners[0][0], corners[1][0], corners[2][0]})));
+                int maxX = static_cast<int>(std::ceil(std::max({corners[0][0], corners[1][0], corners[2][0]})));
+                int minY = static_cast<int>(std::floor(std::min({corners[0][1], corners[1][1], corners[2][1]})));
+                int maxY = static_cast<int>(std::ceil(std::max({corners[0][1], corners[1][1], corners[2][1]})));
+                for (int y = minY; y <= maxY; ++y) {
+                    for (int x = minX; x <= maxX; ++x) {
+                        // Pixel centres on the same side of every edge as the opposite corner are inside
+                        bool isInside = true;
+                        for (int edge = 0; edge < 3 && isInside; ++edge) {
+                            const std::array<double, 2> &start = corners[edge];
+                            const std::array<double, 2> &end = corners[(edge + 1) % 3];
+                            double edgeSide = (end[0] - start[0]) * (y + 0.5 - start[1]) - (x + 0.5 - start[0]) * (end[1] - start[1]);
+                            isInside = edgeSide * area >= 0.0;
+                        }
+                        if (isInside) {
+                            plot(x, y, colour);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t bond = 0; bond < snapshot.bonds.size() / 2; ++bond) {
+        int node1 = snapshot.bonds[2 * bond];
+        int node2 = snapshot.bonds[2 * bond + 1];
+        double x1 = snapshot.nodeCoords[2 * node1];
+        double y1 = snapshot.nodeCoords[2 * node1 + 1];
+        std::array<double, 2> start = toPixel(x1, y1);
+        std::array<double, 2> end = toPixel(x1 + minimumImage(snapshot.nodeCoords[2 * node2] - x1, dimensions[0]),
+                                            y1 + minimumImage(snapshot.nodeCoords[2 * node2 + 1] - y1, dimensions[1]));
+        int numSteps = static_cast<int>(std::ceil(std::max(std::abs(end[0] - start[0]), std::abs(end[1] - start[1])))) + 1;
+        for (int step = 0; step <= numSteps; ++step) {
+            double fraction = static_cast<double>(step) / numSteps;
+            int x = static_cast<int>(std::floor(start[0] + fraction * (end[0] - start[0])));
+            int y = static_cast<int>(std::floor(start[1] + fraction * (end[1] - start[1])));
+            plot(x, y, BOND_COLOUR);
+            plot(x + 1, y, BOND_COLOUR);
+            plot(x, y + 1, BOND_COLOUR);
+        }
+    }
+    for (size_t node = 0; node < snapshot.nodeCoords.size() / 2; ++node) {
+        std::array<double, 2> centre = toPixel(snapshot.nodeCoords[2 * node], snapshot.nodeCoords[2 * node + 1]);
+        int x = static_cast<int>(std::floor(centre[0]));
+        int y = static_cast<int>(std::floor(centre[1]));
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                plot(x + dx, y + dy, NODE_COLOUR);
+            }
+        }
+    }
+
+    std::ostringstream fileName;
+    fileName << "frame_" << std::setw(6) << std::setfill('0') << snapshot.frameNumber << ".ppm";
+    std::string path = (std::filesystem::path(directory) / fileName.str()).string();
+    std::ofstream frameFile(path, std::ios::binary);
+    if (!frameFile) {
+        throw std::runtime_error("Unable to open movie frame: " + path);
+    }
+    frameFile << "P6\n"
+              << width << " " << height << "\n255\n";
+    frameFile.write(reinterpret_cast<const char *>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    if (!frameFile) {
+        throw std::runtime_error("Unable to write movie frame: " + path);
+    }
+}
@@ -0,0 +1,381 @@
+#include "half_edge_mesh.h"
+#include <algorithm>
+
+/**
+ * @brief Default constructor
+ */
+HalfEdgeMesh::HalfEdgeMesh() = default;
+
+/**
+ * @brief Build the half-edges of a base network, ordering the half-edges leaving every node clockwise and numbering
+ * the faces after the rings of the ring network. A half-edge u -> v is followed around its ring by v -> w, where w is
+ * the neighbour after u clockwise around v, as in Network::deriveRingNetwork.
+ * @param baseNetwork The base network, whose coordinates give the clockwise order of every node's neighbours
+ * @param ringNetwork The ring network, whose rings must be the faces of the base network
+ * @throw std::runtime_error if a face of the base network is not a ring of the ring network or a ring is not a face
+ */
+HalfEdgeMesh::HalfEdgeMesh(const Network &baseNetwork, const Network &ringNetwork) {
+    int numNodes = baseNetwork.nodes.size();
+    std::vector<std::vector<int>> outgoingEdges(numNodes);
+    for (const Node &node : baseNetwork.nodes) {
+        for (const int &cnx : node.netConnections) {
+            if (cnx > node.id) {
+                outgoingEdges[node.id].push_back(origins.size());
+                origins.push_back(node.id);
+                outgoingEdges[cnx].push_back(origins.size());
+                origins.push_back(cnx);
+            }
+        }
+    }
+    int numHalfEdges = origins.size();
+    rotationNext.resize(numHalfEdges);
+    rotationPrev.resize(numHalfEdges);
+    vertexEdges.assign(numNodes, -1);
+    for (int nodeID = 0; nodeID < numNodes; ++nodeID) {
+        std::vector<std::pair<double, int>> angles;
+        angles.reserve(outgoingEdges[nodeID].size());
+        for (const int &halfEdge : outgoingEdges[nodeID]) {
+            angles.emplace_back(getClockwiseAngle(baseNetwork.nodes[nodeID].crd, baseNetwork.nodes[getDestination(halfEdge)].crd,
+                                                  baseNetwork.dimensions), halfEdge);
+        }
+        std::sort(angles.begin(), angles.end());
+        for (size_t i = 0; i < angles.size(); ++i) {
+            rotationNext[angles[i].second] = angles[(i + 1) % angles.size()].second;
+            rotationPrev[angles[i].second] = angles[(i + angles.size() - 1) % angles.size()].second;
+        }
+        if (!angles.empty()) {
+            vertexEdges[nodeID] = angles.front().second;
+        }
+    }
+
+    // Every cycle of getNext is a face, which is matched to the ring holding exactly its nodes
+    faces.assign(numHalfEdges, -1);
+    faceEdges.assign(ringNetwork.nodes.size(), -1);
+    for (int start = 0; start < numHalfEdges; ++start) {
+        if (faces[start] != -1) {
+            continue;
+        }
+        std::vector<int> faceNodes;
+        int halfEdge = start;
+        do {
+            faceNodes.push_back(origins[halfEdge]);
+            halfEdge = getNext(halfEdge);
+        } while (halfEdge != start);
+        int face = -1;
+        for (const int &ring : baseNetwork.nodes[origins[start]].dualConnections) {
+            const std::vector<int> &ringNodes = ringNetwork.nodes[ring].dualConnections;
+            if (ringNodes.size() == faceNodes.size() &&
+                std::all_of(faceNodes.begin(), faceNodes.end(), [&ringNodes](const int &id) { return vectorContains(ringNodes, id); })) {
+                face = ring;
+                break;
+            }
+        }
+        if (face == -1 || faceEdges[face] != -1) {
+            throw std::runtime_error("Face of the base network starting at node " + std::to_string(origins[start]) +
+                                     " is not a ring of the ring network");
+        }
+        faceEdges[face] = start;
+        halfEdge = start;
+        do {
+            faces[halfEdge] = face;
+            halfEdge = getNext(halfEdge);
+        } while (halfEdge != start);
+    }
+    if (auto it = std::find(faceEdges.begin(), faceEdges.end(), -1); it != faceEdges.end()) {
+        throw std::runtime_error("Ring " + std::to_string(it - faceEdges.begin()) + " is not a face of the base network");
+    }
+}
+
+/**
+ * @brief Get the base node a half-edge points to
+ * @param halfEdge ID of the half-edge
+ * @return ID of the base node at the end of the half-edge
+ */
+int HalfEdgeMesh::getDestination(const int &halfEdge) const {
+    return origins[halfEdge ^ 1];
+}
+
+/**
+ * @brief Get the half-edge after this one around its ring
+ * @param halfEdge ID of the half-edge
+ * @return ID of the next half-edge
+ */
+int HalfEdgeMesh::getNext(const int &halfEdge) const {
+    return rotationNext[halfEdge ^ 1];
+}
+
+/**
+ * @brief Get the half-edge before this one around its ring
+ * @param halfEdge ID of the half-edge
+ * @return ID of the previous half-edge
+ */
+int HalfEdgeMesh::getPrev(const int &halfEdge) const {
+    return rotationPrev[halfEdge] ^ 1;
+}
+
+/**
+ * @brief Find the half-edge from one base node to another by walking around the first node
+ * @param node1 ID of the base node the half-edge leaves
+ * @param node2 ID of the base node the half-edge points to
+ * @return ID of the half-edge, or -1 if the nodes are not bonded
+ */
+int HalfEdgeMesh::findHalfEdge(const int &node1, const int &node2) const {
+    int start = vertexEdges[node1];
+    if (start == -1) {
+        return -1;
+    }
+    int halfEdge = start;
+    do {
+        if (getDestination(halfEdge) == node2) {
+            return halfEdge;
+        }
+        halfEdge = rotationNext[halfEdge];
+    } while (halfEdge != start);
+    return -1;
+}
+
+/**
+ * @brief Get the neighbours of a base node
+ * @param node ID of the base node
+ * @return IDs of the neighbours in clockwise order
+ */
+std::vector<int> HalfEdgeMesh::getNeighbours(const int &node) const {
+    std::vector<int> neighbours;
+    int start = vertexEdges[node];
+    if (start == -1) {
+        return neighbours;
+    }
+    int halfEdge = start;
+    do {
+        neighbours.push_back(getDestination(halfEdge));
+        halfEdge = rotationNext[halfEdge];
+    } while (halfEdge != start);
+    return neighbours;
+}
+
+/**
+ * @brief Get the base nodes of a ring
+ * @param face ID of the ring
+ * @return IDs of the base nodes in order around the ring
+ */
+std::vector<int> HalfEdgeMesh::getFaceNodes(const int &face) const {
+    std::vector<int> faceNodes;
+    int halfEdge = faceEdges[face];
+    do {
+        faceNodes.push_back(origins[halfEdge]);
+        halfEdge = getNext(halfEdge);
+    } while (halfEdge != faceEdges[face]);
+    return faceNodes;
+}
+
+/**
+ * @brief Get the number of base nodes in a ring
+ * @param face ID of the ring
+ * @return Size of the ring
+ */
+int HalfEdgeMesh::getFaceSize(const int &face) const {
+    int size = 0;
+    int halfEdge = faceEdges[face];
+    do {
+        size++;
+        halfEdge = getNext(halfEdge);
+    } while (halfEdge != faceEdges[face]);
+    return size;
+}
+
+/**
+ * @brief Get the area of a ring with the shoelace formula, unwrapping each bond across the periodic boundary. The
+ * nodes are already in order around the ring, so unlike calculatePolygonArea they are not sorted by angle first.
+ * @param face ID of the ring
+ * @param coords Coordinates of the base nodes (1D vector of pairs)
+ * @param dimensions Periodic boundary of the network
+ * @return Area of the ring
+ */
+double HalfEdgeMesh::getFaceArea(const int &face, const std::vector<double> &coords, const std::vector<double> &dimensions) const {
+    double x = 0.0;
+    double y = 0.0;
+    double area = 0.0;
+    int halfEdge = faceEdges[face];
+    do {
+        int node1 = origins[halfEdge];
+        int node2 = getDestination(halfEdge);
+        std::vector<double> bond = pbcVector({coords[2 * node1], coords[2 * node1 + 1]}, {coords[2 * node2], coords[2 * node2 + 1]}, dimensions);
+        area += x * (y + bond[1]) - (x + bond[0]) * y;
+        x += bond[0];
+        y += bond[1];
+        halfEdge = getNext(halfEdge);
+    } while (halfEdge != faceEdges[face]);
+    return std::abs(area) / 2.0;
+}
+
+/**
+ * @brief Get the perimeter of a ring, measuring each bond across the periodic boundary
+ * @param face ID of the ring
+ * @param coords Coordinates of the base nodes (1D vector of pairs)
+ * @param dimensions Periodic boundary of the network
+ * @return Sum of the lengths of the bonds around the ring
+ */
+double HalfEdgeMesh::getFacePerimeter(const int &face, const std::vector<double> &coords, const std::vector<double> &dimensions) const {
+    double perimeter = 0.0;
+    int halfEdge = faceEdges[face];
+    do {
+        int node1 = origins[halfEdge];
+        int node2 = getDestination(halfEdge);
+        std::vector<double> bond = pbcVector({coords[2 * node1], coords[2 * node1 + 1]}, {coords[2 * node2], coords[2 * node2 + 1]}, dimensions);
+        perimeter += std::hypot(bond[0], bond[1]);
+        halfEdge = getNext(halfEdge);
+    } while (halfEdge != faceEdges[face]);
+    return perimeter;
+}
+
+/**
+ * @brief Switch the bond between atom1 and atom2 by rewriting a constant number of indices. The bonds atom1-breakNode1
+ * and atom2-breakNode2 become atom1-breakNode2 and atom2-breakNode1, reusing their half-edges, and the rings either
+ * side of the switched bond lose a node while the rings at its ends gain one. Switching again with the break nodes
+ * swapped undoes the switch exactly.
+ * @param atom1 ID of the first base node of the switched bond
+ * @param atom2 ID of the second base node of the switched bond
+ * @param breakNode1 ID of the neighbour of atom1 that becomes a neighbour of atom2
+ * @param breakNode2 ID of the neighbour of atom2 that becomes a neighbour of atom1
+ * @throw std::invalid_argument if any of the bonds do not exist
+ */
+void HalfEdgeMesh::switchBond(const int &atom1, const int &atom2, const int &breakNode1, const int &breakNode2) {
+    int centralEdge = findHalfEdge(atom1, atom2);
+    int breakEdge1 = findHalfEdge(atom1, breakNode1);
+    int breakEdge2 = findHalfEdge(atom2, breakNode2);
+    if (centralEdge == -1 || breakEdge1 == -1 || breakEdge2 == -1) {
+        throw std::invalid_argument("Cannot switch bond " + std::to_string(atom1) + "-" + std::to_string(atom2) + " breaking bonds to " +
+                                    std::to_string(breakNode1) + " and " + std::to_string(breakNode2) + " as the bonds do not exist");
+    }
+    // The switched bond rotates, so each kept half-edge swings to the other side of it
+    moveBeside(breakEdge1, centralEdge);
+    moveBeside(breakEdge2, centralEdge ^ 1);
+
+    // The far ends of the two bonds trade places
+    swapRotationSlots(breakEdge1 ^ 1, breakEdge2 ^ 1);
+    origins[breakEdge1 ^ 1] = breakNode2;
+    origins[breakEdge2 ^ 1] = breakNode1;
+    vertexEdges[breakNode2] = breakEdge1 ^ 1;
+    vertexEdges[breakNode1] = breakEdge2 ^ 1;
+
+    std::vector<int> changedEdges = {centralEdge, centralEdge ^ 1, breakEdge1, breakEdge1 ^ 1, breakEdge2, breakEdge2 ^ 1};
+    for (const int &halfEdge : changedEdges) {
+        relabelFace(halfEdge, changedEdges);
+    }
+}
+
+/**
+ * @brief Move a half-edge next to the central half-edge it neighbours clockwise to the other side of it
+ * @param halfEdge ID of the half-edge to move, which must be next to centralEdge around their origin
+ * @param centralEdge ID of the half-edge it moves around
+ * @throw std::invalid_argument if the half-edges are not next to each other
+ */
+void HalfEdgeMesh::moveBeside(const int &halfEdge, const int &centralEdge) {
+    bool isAfter = rotationNext[centralEdge] == halfEdge;
+    if (!isAfter && rotationPrev[centralEdge] != halfEdge) {
+        throw std::invalid_argument("Half-edge " + std::to_string(halfEdge) + " is not next to half-edge " + std::to_string(centralEdge));
+    }
+    rotationNext[rotationPrev[halfEdge]] = rotationNext[halfEdge];
+    rotationPrev[rotationNext[halfEdge]] = rotationPrev[halfEdge];
+    int before = isAfter ? rotationPrev[centralEdge] : centralEdge;
+    int after = rotationNext[before];
+    rotationNext[before] = halfEdge;
+    rotationPrev[after] = halfEdge;
+    rotationPrev[halfEdge] = before;
+    rotationNext[halfEdge] = after;
+}
+
+/**
+ * @brief Swap the positions of two half-edges leaving different nodes in the clockwise order around their origins
+ * @param halfEdge1 ID of the first half-edge
+ * @param halfEdge2 ID of the second half-edge
+ */
+void HalfEdgeMesh::swapRotationSlots(const int &halfEdge1, const int &halfEdge2) {
+    int prev1 = rotationPrev[halfEdge1];
+    int next1 = rotationNext[halfEdge1];
+    int prev2 = rotationPrev[halfEdge2];
+    int next2 = rotationNext[halfEdge2];
+    auto place = [this](const int &halfEdge, const int &oldEdge, const int &prev, const int &next) {
+        // A half-edge that was alone around its origin leaves the one replacing it alone too
+        if (prev == oldEdge) {
+            rotationNext[halfEdge] = halfEdge;
+            rotationPrev[halfEdge] = halfEdge;
+            return;
+        }
+        rotationNext[prev] = halfEdge;
+        rotationPrev[next] = halfEdge;
+        rotationPrev[halfEdge] = prev;
+        rotationNext[halfEdge] = next;
+    };
+    place(halfEdge2, halfEdge1, prev1, next1);
+    place(halfEdge1, halfEdge2, prev2, next2);
+}
+
+/**
+ * @brief Give every half-edge around the ring of a half-edge the ring of the first half-edge around it that was not
+ * changed by a switch, since those keep their rings
+ * @param halfEdge ID of a half-edge around the ring
+ * @param changedEdges IDs of the half-edges changed by the switch
+ * @throw std::runtime_error if every half-edge around the ring was changed
+ */
+void HalfEdgeMesh::relabelFace(const int &halfEdge, const std::vector<int> &changedEdges) {
+    int face = -1;
+    int current = halfEdge;
+    do {
+        if (std::find(changedEdges.begin(), changedEdges.end(), current) == changedEdges.end()) {
+            face = faces[current];
+            break;
+        }
+        current = getNext(current);
+    } while (current != halfEdge);
+    if (face == -1) {
+        throw std::runtime_error("Cannot find the ring of half-edge " + std::to_string(halfEdge) + " after switching");
+    }
+    current = halfEdge;
+    do {
+        faces[current] = face;
+        current = getNext(current);
+    } while (current != halfEdge);
+    faceEdges[face] = halfEdge;
+}
+
+/**
+ * @brief Check that the half-edges describe the same bonds and rings as the networks
+ * @param baseNetwork The base network
+ * @param ringNetwork The ring network
+ * @param logger The logger to log differences to
+ * @return true if every node has the same neighbours and every ring has the same nodes, false otherwise
+ */
+bool HalfEdgeMesh::checkConsistency(const Network &baseNetwork, const Network &ringNetwork, const LoggerPtr &logger) const {
+    bool consistent = true;
+    for (const Node &node : baseNetwork.nodes) {
+        std::vector<int> neighbours = getNeighbours(node.id);
+        std::vector<int> expected = node.netConnections;
+        std::sort(neighbours.begin(), neighbours.end());
+        std::sort(expected.begin(), expected.end());
+        if (neighbours != expected) {
+            logger->error("Node {} base has different neighbours in the half-edge mesh", node.id);
+            consistent = false;
+        }
+    }
+    for (const Node &ring : ringNetwork.nodes) {
+        std::vector<int> faceNodes = getFaceNodes(ring.id);
+        std::vector<int> expected = ring.dualConnections;
+        std::sort(faceNodes.begin(), faceNodes.end());
+        std::sort(expected.begin(), expected.end());
+        if (faceNodes != expected) {
+            logger->error("Node {} ring has different base nodes in the half-edge mesh", ring.id);
+            consistent = false;
+        }
+    }
+    return consistent;
+}
+
+/**
+ * @brief Estimate the memory held by the half-edges
+ * @return Number of bytes allocated
+ */
+size_t HalfEdgeMesh::getMemoryUsage() const {
+    return (origins.capacity() + rotationNext.capacity() + rotationPrev.capacity() + faces.capacity() +
+            vertexEdges.capacity() + faceEdges.capacity()) * sizeof(int);
+}
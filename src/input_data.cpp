@@ -1,4 +1,5 @@
 #include "input_data.h"
+#include <algorithm>
 #include <filesystem>
 
 /**
@@ -6,14 +7,33 @@
  * @param filePath The path to the input file
  * @param loggerArg The log file
  */
-InputData::InputData(const std::string &filePath, const LoggerPtr &loggerArg) : inputFile(filePath), logger(loggerArg) {
+InputData::InputData(const std::string &filePath, const LoggerPtr &loggerArg) : logger(loggerArg) {
+    std::ifstream file(filePath);
 
     // Check if the file was opened successfully
-    if (!inputFile.is_open()) {
+    if (!file.is_open()) {
         throw std::runtime_error("Unable to open file: " + filePath);
     }
     logger->debug("Reading input file: " + filePath);
+    inputFile << file.rdbuf();
+    read();
+}
+
+/**
+ * @brief Reads input in the same format as the input file from a stream, such as a string held in memory
+ * @param input The stream to read from
+ * @param loggerArg The log file
+ */
+InputData::InputData(std::istream &input, const LoggerPtr &loggerArg) : logger(loggerArg) {
+    inputFile << input.rdbuf();
+    read();
+}
 
+/**
+ * @brief Reads every section of the input and validates it
+ * @throws std::runtime_error if any value is missing or invalid
+ */
+void InputData::read() {
     // Skip the title line
     inputFile.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     lineNumber++;
@@ -23,6 +43,8 @@ InputData::InputData(const std::string &filePath, const LoggerPtr &loggerArg) :
     readBondSelectionProcess();
     readTemperatureSchedule();
     readAnalysis();
+    readPerformance();
+    readSampling();
 
     // Validate input data
     logger->debug("Validating input data...");
@@ -58,7 +80,8 @@ std::string InputData::getFirstWord() {
 }
 
 void InputData::readNetworkRestrictions() {
-    readSection("Network Restrictions",  minRingSize, maxRingSize, maximumBondLength, maximumAngle, isFixRingsEnabled);
+    readSection("Network Restrictions",  minRingSize, maxRingSize, maximumBondLength, maximumAngle, isFixRingsEnabled,
+                activeRegion, activeRegionShells, activeRegionRadius);
 }
 
 void InputData::readBondSelectionProcess() {
@@ -67,11 +90,26 @@ void InputData::readBondSelectionProcess() {
 
 void InputData::readTemperatureSchedule() {
     readSection("Temperature", thermalisationTemperature, annealingStartTemperature,
-                annealingEndTemperature, thermalisationSteps, annealingSteps);
+                annealingEndTemperature, thermalisationSteps, annealingSteps,
+                topologyOnlyTemperature, topologyOnlyRelaxInterval);
 }
 
 void InputData::readAnalysis() {
-    readSection("Analysis", analysisWriteInterval, writeMovie);
+    readSection("Analysis", analysisWriteInterval, writeMovie, movieRenderer, colourRingsInMovie,
+                stopWhenEquilibrated, equilibrationEffectiveSamples, equilibrationTolerance, ringAreaTolerance, heatmapGridSize);
+}
+
+void InputData::readPerformance() {
+    readSection("Performance", topologyCacheSize, skipRelaxationOnCacheHit, reuseProposalOutcomes,
+                pipelineProposals, isLeanMemory,
+                deriveRingNetwork, useRelaxationTemplates,
+                switchBatchSize, batchRegionRadius, atomSortInterval, nodeOrdering,
+                autotuneMoves, autotuneEnergyTolerance, topologyAuditInterval, packedReplicas);
+}
+
+void InputData::readSampling() {
+    readSection("Sampling", isWangLandauEnabled, wangLandauOrderParameter, wangLandauMinimum, wangLandauMaximum,
+                wangLandauBins, wangLandauFlatness, wangLandauFinalModification, wangLandauMaxSteps, wangLandauWalkers);
 }
 
 /**
@@ -98,12 +136,18 @@ void InputData::validate() const {
     if (isFixRingsEnabled) {
         checkFileExists(std::filesystem::path("./input_files") / "bss_network" / "fixed_rings.txt");
     }
+    checkInRange(activeRegionShells, 0, INT_MAX, "Active region shells must be at least 0");
+    checkInRange(activeRegionRadius, 0.0, std::numeric_limits<double>::max(), "Active region radius must be at least 0");
+    if (activeRegion != ActiveRegion::NONE && !isFixRingsEnabled) {
+        throw std::runtime_error("An active region is measured from the fixed rings, so fixed rings must be enabled");
+    }
     // Monte Carlo Process
     checkInRange(randomSeed, 0, INT_MAX, "Random seed must be at least 0");
 
     // Monte Carlo Energy Searcg
     checkInRange(annealingSteps, 0, INT_MAX, "Annealing steps must be at least 0");
     checkInRange(thermalisationSteps, 0, INT_MAX, "Thermalisation steps must be at least 0");
+    checkInRange(topologyOnlyRelaxInterval, 0, INT_MAX, "Topology-only relaxation interval must be at least 0");
     checkInRange(maximumBondLength, 0.0, std::numeric_limits<double>::max(), "Maximum bond length must be at least 0");
     checkInRange(maximumAngle, 0.0, 360.0, "Maximum angle must be between 0 and 360");
 
@@ -111,7 +155,68 @@ void InputData::validate() const {
     if (analysisWriteInterval < 0) {
         throw std::runtime_error("Analysis write interval must be at least 0");
     }
-    if (writeMovie && thermalisationSteps + annealingSteps > 2000) {
+    if (writeMovie && movieRenderer == MovieRenderer::LAMMPS && thermalisationSteps + annealingSteps > 2000) {
         throw std::runtime_error("Cannot write a movie file for more than 2000 steps because the file would be enormous");
     }
+    if (stopWhenEquilibrated && analysisWriteInterval == 0) {
+        throw std::runtime_error("Stopping stages when equilibrated needs an analysis write interval of at least 1");
+    }
+    checkInRange(equilibrationEffectiveSamples, 0, INT_MAX, "Equilibration effective samples must be at least 0");
+    checkInRange(equilibrationTolerance, 0.0, std::numeric_limits<double>::max(), "Equilibration tolerance must be at least 0");
+    checkInRange(ringAreaTolerance, 0.0, std::numeric_limits<double>::max(), "Ring area tolerance must be at least 0");
+    checkInRange(heatmapGridSize, 0, INT_MAX, "Switch heatmap grid size must be at least 0");
+
+    // Performance
+    checkInRange(topologyCacheSize, 0, INT_MAX, "Topology cache size must be at least 0");
+    if (reuseProposalOutcomes && (topologyCacheSize > 0 || useRelaxationTemplates)) {
+        throw std::runtime_error("Repeated proposals cannot be reused with the topology cache or relaxation templates, "
+                                 "because they change where a repeated proposal's minimisation starts");
+    }
+    checkInRange(switchBatchSize, 1, INT_MAX, "Switches per relaxation must be at least 1");
+    checkInRange(batchRegionRadius, 0, INT_MAX, "Batch region radius must be at least 0");
+    checkInRange(atomSortInterval, 0, INT_MAX, "LAMMPS atom sort interval must be at least 0");
+    checkInRange(autotuneMoves, 0, INT_MAX, "Autotune calibration moves must be at least 0");
+    checkInRange(autotuneEnergyTolerance, 0.0, std::numeric_limits<double>::max(), "Autotune energy tolerance must be at least 0");
+    checkInRange(topologyAuditInterval, 0, INT_MAX, "Topology audit interval must be at least 0");
+    if (topologyAuditInterval > 0 && minRingSize < 4) {
+        throw std::runtime_error("Topology audits need a minimum ring size of at least 4, because triangles can only be switched when every edit is verified");
+    }
+    checkInRange(packedReplicas, 1, INT_MAX, "Packed replicas must be at least 1");
+    if (packedReplicas > 1) {
+        if (activeRegion != ActiveRegion::NONE) {
+            throw std::runtime_error("Packed replicas cannot be used with an active region");
+        }
+        if (switchBatchSize > 1 || topologyCacheSize > 0 || reuseProposalOutcomes || pipelineProposals || useRelaxationTemplates ||
+            autotuneMoves > 0 || topologyAuditInterval > 0) {
+            throw std::runtime_error("Packed replicas cannot be used with batched switches, the topology cache, reused or pipelined proposals, "
+                                     "relaxation templates, autotuning or topology audits");
+        }
+        if (writeMovie || stopWhenEquilibrated || heatmapGridSize > 0 || isWangLandauEnabled) {
+            throw std::runtime_error("Packed replicas cannot be used with a movie, equilibration detection, the switch heatmap or Wang-Landau sampling");
+        }
+        if (randomOrWeighted == SelectionType::STRAIN) {
+            throw std::runtime_error("Packed replicas need random or weighted bond selection, because strain selection reads every atom energy after each move");
+        }
+        if (topologyOnlyTemperature <= std::max({thermalisationTemperature, annealingStartTemperature, annealingEndTemperature})) {
+            throw std::runtime_error("Packed replicas cannot make topology-only switches, so the topology-only temperature threshold must be above every temperature");
+        }
+    }
+
+    // Sampling
+    if (isWangLandauEnabled) {
+        if (wangLandauMaximum <= wangLandauMinimum) {
+            throw std::runtime_error("Wang-Landau maximum must be greater than the minimum");
+        }
+        checkInRange(wangLandauBins, 1, INT_MAX, "Wang-Landau bins must be at least 1");
+        checkInRange(wangLandauFlatness, 0.0, 1.0, "Wang-Landau flatness must be between 0 and 1");
+        checkInRange(wangLandauFinalModification, 0.0, 1.0, "Wang-Landau final modification factor must be between 0 and 1");
+        checkInRange(wangLandauMaxSteps, 0, INT_MAX, "Wang-Landau maximum steps must be at least 0");
+        checkInRange(wangLandauWalkers, 1, INT_MAX, "Wang-Landau walkers must be at least 1");
+        if (randomOrWeighted != SelectionType::RANDOM) {
+            throw std::runtime_error("Wang-Landau sampling needs random bond selection so that moves are reversible");
+        }
+        if (writeMovie && wangLandauWalkers > 1) {
+            throw std::runtime_error("Cannot write a movie with more than one Wang-Landau walker");
+        }
+    }
 }
@@ -0,0 +1,297 @@
+#include "job_server.h"
+#include <algorithm>
+#include <cctype>
+#include <csignal>
+#include <fstream>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @brief Default constructor
+ */
+JobDescription::JobDescription() = default;
+
+/**
+ * @brief Read a job file, made of lines of the form
+ *     input <folder holding bss_parameters.txt, bss_network and lammps_files>
+ *     output <folder to run in, results are written to its output_files>
+ *     set <start of a parameter's description in bss_parameters.txt> = <value>
+ * Blank lines and lines starting with # are ignored. Without an input folder, the output folder must already
+ * hold input_files, as when running the simulator directly.
+ * @param filePath The path to the job file
+ * @throw std::runtime_error if the file cannot be read, a line is not understood or there is no output folder
+ */
+JobDescription::JobDescription(const std::string &filePath) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open job file: " + filePath);
+    }
+    auto trim = [](const std::string &text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        return first == std::string::npos ? std::string() : text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+    };
+    std::string line;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t keyEnd = line.find_first_of(" \t");
+        std::string key = line.substr(0, keyEnd);
+        std::string value = keyEnd == std::string::npos ? "" : trim(line.substr(keyEnd));
+        if (key == "input") {
+            inputDirectory = std::filesystem::absolute(value);
+        } else if (key == "output") {
+            outputDirectory = std::filesystem::absolute(value);
+        } else if (size_t equals = value.find('='); key == "set" && equals != std::string::npos) {
+            overrides.emplace_back(trim(value.substr(0, equals)), trim(value.substr(equals + 1)));
+        } else {
+            throw std::runtime_error("Invalid line in job file " + filePath + ": " + line);
+        }
+    }
+    if (outputDirectory.empty()) {
+        throw std::runtime_error("Job file " + filePath + " has no output folder");
+    }
+}
+
+/**
+ * @brief Construct a server, creating the spool directory if it does not exist
+ * @param spoolDirectoryArg Folder polled for .job files
+ * @param numWorkersArg Number of worker processes running jobs side by side
+ * @param runJobArg Runs a simulation in the current directory from its input data, logging to the given logger
+ * @param loggerArg The logger of the server
+ * @throw std::invalid_argument if there are no workers
+ */
+JobServer::JobServer(const std::string &spoolDirectoryArg, const int &numWorkersArg, const JobRunner &runJobArg,
+                     const LoggerPtr &loggerArg)
+    : spoolDirectory(std::filesystem::absolute(spoolDirectoryArg)),
+      numWorkers(numWorkersArg),
+      runJob(runJobArg),
+      logger(loggerArg) {
+    if (numWorkers < 1) {
+        throw std::invalid_argument("Job server needs at least one worker");
+    }
+    std::filesystem::create_directories(spoolDirectory);
+}
+
+/**
+ * @brief Start the workers and keep them running until the stop flag is set, replacing any that die. The workers are
+ * then interrupted, so their running jobs stop as an interrupted run does.
+ * @param stopFlag Set to stop the server, such as by the SIGINT handler
+ */
+void JobServer::run(const std::atomic<bool> &stopFlag) {
+    logger->info("Serving jobs from {} with {} workers", spoolDirectory.string(), numWorkers);
+    std::vector<pid_t> workers;
+    for (int workerID = 0; workerID < numWorkers; ++workerID) {
+        workers.push_back(startWorker(workerID, stopFlag));
+    }
+    while (!stopFlag) {
+        int status;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid <= 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(pollInterval));
+            continue;
+        }
+        auto it = std::find(workers.begin(), workers.end(), pid);
+        if (it == workers.end() || stopFlag) {
+            continue;
+        }
+        int workerID = static_cast<int>(it - workers.begin());
+        logger->warn("Worker {} exited unexpectedly with status {}, restarting it. Its job is left as .running", workerID, status);
+        *it = startWorker(workerID, stopFlag);
+    }
+    // A worker already interrupted by the same Ctrl + C only sets its stop flag again
+    logger->info("Stopping, waiting for the workers to stop their jobs...");
+    for (const pid_t &pid : workers) {
+        kill(pid, SIGINT);
+    }
+    for (const pid_t &pid : workers) {
+        waitpid(pid, nullptr, 0);
+    }
+    logger->info("Job server stopped");
+}
+
+/**
+ * @brief Fork a worker process that runs jobs until the stop flag is set
+ * @param workerID Index of the worker, for logging
+ * @param stopFlag Set to stop the worker after its current job
+ * @return Process ID of the worker
+ * @throw std::runtime_error if the process cannot be forked
+ */
+pid_t JobServer::startWorker(const int &workerID, const std::atomic<bool> &stopFlag) {
+    logger->flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("Failed to fork job server worker " + std::to_string(workerID));
+    }
+    if (pid == 0) {
+        int exitCode = 0;
+        try {
+            runWorker(workerID, stopFlag);
+        } catch (std::exception &e) {
+            logger->error("Worker {} failed: {}", workerID, e.what());
+            exitCode = 1;
+        }
+        logger->flush();
+        // Skip the destructors of the objects copied from the server
+        _exit(exitCode);
+    }
+    return pid;
+}
+
+/**
+ * @brief Run jobs one after another until the stop flag is set
+ * @param workerID Index of the worker, for logging
+ * @param stopFlag Set to stop the worker after its current job
+ */
+void JobServer::runWorker(const int &workerID, const std::atomic<bool> &stopFlag) {
+    while (!stopFlag) {
+        std::optional<std::filesystem::path> jobPath = claimJob();
+        if (!jobPath) {
+            std::this_thread::sleep_for(std::chrono::seconds(pollInterval));
+            continue;
+        }
+        runClaimedJob(*jobPath, workerID);
+    }
+}
+
+/**
+ * @brief Claim the first job in the spool directory by name by renaming it from .job to .running, which only one
+ * worker can do
+ * @return Path to the claimed job, or nothing if there are no jobs waiting
+ */
+std::optional<std::filesystem::path> JobServer::claimJob() const {
+    std::vector<std::filesystem::path> jobPaths;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(spoolDirectory, error)) {
+        if (entry.path().extension() == ".job") {
+            jobPaths.push_back(entry.path());
+        }
+    }
+    std::sort(jobPaths.begin(), jobPaths.end());
+    for (const std::filesystem::path &jobPath : jobPaths) {
+        std::filesystem::path runningPath = std::filesystem::path(jobPath).replace_extension(".running");
+        std::filesystem::rename(jobPath, runningPath, error);
+        if (!error) {
+            return runningPath;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Run a claimed job in its output folder, logging to output_files/bond_switch_simulator.log there, then
+ * rename it to .done, to .interrupted if it was stopped by SIGINT, or to .failed with the reason appended
+ * @param jobPath Path to the claimed .running job file
+ * @param workerID Index of the worker running the job, for logging
+ */
+void JobServer::runClaimedJob(const std::filesystem::path &jobPath, const int &workerID) {
+    std::string jobName = jobPath.stem().string();
+    logger->info("Worker {} started job {}", workerID, jobName);
+    auto start = std::chrono::steady_clock::now();
+    std::filesystem::path serverDirectory = std::filesystem::current_path();
+    std::string failure;
+    bool isInterrupted = false;
+    try {
+        JobDescription job(jobPath.string());
+        std::filesystem::create_directories(job.outputDirectory / "output_files");
+        if (!job.inputDirectory.empty() && !std::filesystem::exists(job.outputDirectory / "input_files")) {
+            std::filesystem::create_directory_symlink(job.inputDirectory, job.outputDirectory / "input_files");
+        }
+        std::filesystem::current_path(job.outputDirectory);
+
+        auto fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(std::filesystem::path("./output_files") / "bond_switch_simulator.log", true);
+        auto jobLogger = std::make_shared<spdlog::logger>("job_" + jobName, fileSink);
+        jobLogger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+        jobLogger->set_level(logger->level());
+        try {
+            std::ifstream parametersFile(std::filesystem::path("./input_files") / "bss_parameters.txt");
+            if (!parametersFile.is_open()) {
+                throw std::runtime_error("Unable to open " + (job.outputDirectory / "input_files" / "bss_parameters.txt").string());
+            }
+            std::ostringstream parameters;
+            parameters << parametersFile.rdbuf();
+            for (const auto &[description, value] : job.overrides) {
+                jobLogger->info("Overriding {} with {}", description, value);
+            }
+            std::istringstream overriddenParameters(applyOverrides(parameters.str(), job.overrides));
+            InputData inputData(overriddenParameters, jobLogger);
+            runJob(inputData, jobLogger);
+        } catch (JobInterrupted &e) {
+            jobLogger->warn("{}", e.what());
+            jobLogger->flush();
+            throw;
+        } catch (std::exception &e) {
+            jobLogger->error("Exception: {}", e.what());
+            jobLogger->flush();
+            throw;
+        }
+        jobLogger->flush();
+    } catch (JobInterrupted &) {
+        isInterrupted = true;
+    } catch (std::exception &e) {
+        failure = e.what();
+    }
+    std::filesystem::current_path(serverDirectory);
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::filesystem::path finishedPath = std::filesystem::path(jobPath).replace_extension(isInterrupted ? ".interrupted" : failure.empty() ? ".done" : ".failed");
+    std::error_code error;
+    std::filesystem::rename(jobPath, finishedPath, error);
+    if (isInterrupted) {
+        logger->warn("Worker {} interrupted job {} after {:.3f} s", workerID, jobName, duration.count());
+    } else if (failure.empty()) {
+        logger->info("Worker {} finished job {} in {:.3f} s", workerID, jobName, duration.count());
+    } else {
+        std::ofstream(finishedPath, std::ios::app) << "# Failed: " << failure << "\n";
+        logger->error("Worker {} failed job {} after {:.3f} s: {}", workerID, jobName, duration.count(), failure);
+    }
+}
+
+/**
+ * @brief Replace the values of parameters in the contents of a bss_parameters.txt file. Each parameter is found by
+ * the start of the description following its value, ignoring case, which has to match exactly one line.
+ * @param parameters The contents of a bss_parameters.txt file
+ * @param overrides Start of each parameter's description and its new value
+ * @return The contents with the values replaced
+ * @throw std::runtime_error if a description matches no line or more than one line
+ */
+std::string JobServer::applyOverrides(const std::string &parameters, const std::vector<std::pair<std::string, std::string>> &overrides) {
+    std::vector<std::string> lines;
+    std::istringstream input(parameters);
+    for (std::string line; std::getline(input, line);) {
+        lines.push_back(line);
+    }
+    auto isSameIgnoringCase = [](const char &a, const char &b) { return std::tolower(a) == std::tolower(b); };
+    for (const auto &[description, value] : overrides) {
+        int match = -1;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            size_t valueEnd = lines[i].find_first_of(" \t");
+            size_t descriptionStart = valueEnd == std::string::npos ? std::string::npos : lines[i].find_first_not_of(" \t", valueEnd);
+            if (descriptionStart == std::string::npos || lines[i].size() - descriptionStart < description.size() ||
+                !std::equal(description.begin(), description.end(), lines[i].begin() + descriptionStart, isSameIgnoringCase)) {
+                continue;
+            }
+            if (match != -1) {
+                throw std::runtime_error("Parameter override '" + description + "' matches more than one line, give more of the description");
+            }
+            match = static_cast<int>(i);
+        }
+        if (match == -1) {
+            throw std::runtime_error("Parameter override '" + description + "' matches no line of bss_parameters.txt");
+        }
+        // Keep the spacing before the description so the file stays aligned where the value fits
+        size_t valueEnd = lines[match].find_first_of(" \t");
+        size_t descriptionStart = lines[match].find_first_not_of(" \t", valueEnd);
+        size_t padding = descriptionStart > value.size() ? descriptionStart - value.size() : 1;
+        lines[match] = value + std::string(padding, ' ') + lines[match].substr(descriptionStart);
+    }
+    std::ostringstream output;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        output << lines[i] << (i + 1 < lines.size() ? "\n" : "");
+    }
+    return output.str();
+}
@@ -3,6 +3,7 @@
 #include <filesystem>
 
 std::string LAMMPS_FILES_PATH = std::filesystem::path("./input_files") / "lammps_files";
+void *LammpsObject::spareHandle = nullptr;
 
 /**
  * @brief Default constructor for a blank Lammps Object
@@ -17,10 +18,18 @@ LammpsObject::LammpsObject() = default;
  */
 LammpsObject::LammpsObject(const LoggerPtr &loggerArg) : logger(loggerArg) {
     logger->debug("Creating Lammps Object");
-    const char *lmpargv[] = {"liblammps", "-screen", "none"};
-    int lmpargc = sizeof(lmpargv) / sizeof(const char *);
-    logger->debug("lmpargc -> {} ", lmpargc);
-    handle = lammps_open_no_mpi(lmpargc, const_cast<char **>(lmpargv), nullptr);
+    if (spareHandle != nullptr) {
+        // Reuse the instance released by the previous object rather than starting LAMMPS again
+        logger->debug("Reusing released LAMMPS handle");
+        handle = spareHandle;
+        spareHandle = nullptr;
+        lammps_command(handle, "clear");
+    } else {
+        const char *lmpargv[] = {"liblammps", "-screen", "none"};
+        int lmpargc = sizeof(lmpargv) / sizeof(const char *);
+        logger->debug("lmpargc -> {} ", lmpargc);
+        handle = lammps_open_no_mpi(lmpargc, const_cast<char **>(lmpargv), nullptr);
+    }
 
     if (handle == nullptr) {
         lammps_mpi_finalize();
@@ -33,6 +42,11 @@ LammpsObject::LammpsObject(const LoggerPtr &loggerArg) : logger(loggerArg) {
     std::string inputFilePath = std::filesystem::path(LAMMPS_FILES_PATH) / "lammps_script.txt";
     logger->debug("Executing LAMMPS Script: {}", inputFilePath);
     lammps_file(handle, inputFilePath.c_str());
+    if (std::ifstream potentialFile(std::filesystem::path(LAMMPS_FILES_PATH) / "lammps_potential.txt"); potentialFile) {
+        std::ostringstream potential;
+        potential << potentialFile.rdbuf();
+        potentialCommands = potential.str();
+    }
     natoms = (int)(lammps_get_natoms(handle) + 0.5);
     if (const auto nbonds_ptr = static_cast<const int *>(lammps_extract_global(handle, "nbonds")); nbonds_ptr) {
         nbonds = *nbonds_ptr;
@@ -48,6 +62,151 @@ LammpsObject::LammpsObject(const LoggerPtr &loggerArg) : logger(loggerArg) {
     logger->debug("LAMMPS #nodes: {} #bonds: {} #angles: {}", natoms, nbonds, nangles);
 }
 
+/**
+ * @brief Constructor for a Lammps Object built from a base network in memory rather than from the files in
+ * ./input_files/lammps_files, with the same settings as lammps_script.txt and nothing written to disk
+ * @param baseNetwork The base network, whose node IDs become the zero-indexed atom IDs
+ * @param potential LAMMPS commands setting up the potential, like the contents of lammps_potential.txt
+ * @param loggerArg The logger object
+ * @throws std::runtime_error if LAMMPS cannot be initialised
+ */
+LammpsObject::LammpsObject(const Network &baseNetwork, const std::string &potential, const LoggerPtr &loggerArg)
+    : LammpsObject(baseNetwork, potential, 1, loggerArg) {
+}
+
+/**
+ * @brief Constructor for a Lammps Object holding several independent copies of a base network in memory, overlaid in
+ * the same box. Replica r has atom IDs r * N + 1 to (r + 1) * N and molecule ID r + 1, so the replicas share no
+ * bonds or angles and pair interactions between them are excluded.
+ * @param baseNetwork The base network, whose node IDs become the zero-indexed atom IDs of the first replica
+ * @param potential LAMMPS commands setting up the potential, like the contents of lammps_potential.txt
+ * @param numReplicas The number of copies of the network
+ * @param loggerArg The logger object
+ * @throws std::runtime_error if LAMMPS cannot be initialised
+ */
+LammpsObject::LammpsObject(const Network &baseNetwork, const std::string &potential, const int &numReplicas, const LoggerPtr &loggerArg)
+    : logger(loggerArg) {
+    logger->debug("Creating Lammps Object from a network in memory with {} replicas", numReplicas);
+    const char *lmpargv[] = {"liblammps", "-screen", "none", "-log", "none"};
+    int lmpargc = sizeof(lmpargv) / sizeof(const char *);
+    handle = lammps_open_no_mpi(lmpargc, const_cast<char **>(lmpargv), nullptr);
+    if (handle == nullptr) {
+        lammps_mpi_finalize();
+        throw std::runtime_error("LAMMPS initialization failed");
+    }
+    version = lammps_version(handle);
+
+    std::ostringstream setup;
+    setup << "units electron\n"
+          << "dimension 2\n"
+          << "processors * * *\n"
+          << "boundary p p p\n"
+          << "atom_style molecular\n"
+          << "region box block 0 " << baseNetwork.dimensions[0] << " 0 " << baseNetwork.dimensions[1] << " -0.5 0.5\n"
+          << "create_box 1 box bond/types 1 angle/types 1 extra/bond/per/atom 6 extra/angle/per/atom 12 extra/special/per/atom 24\n"
+          << "labelmap atom 1 C\n"
+          << "labelmap bond 1 C-C\n"
+          << "labelmap angle 1 C-C-C\n"
+          << "mass 1 12.011\n";
+    setup << std::setprecision(17);
+    int numNodes = static_cast<int>(baseNetwork.nodes.size());
+    for (int replica = 0; replica < numReplicas; ++replica) {
+        for (const Node &node : baseNetwork.nodes) {
+            setup << "create_atoms 1 single " << node.crd[0] << " " << node.crd[1] << " 0.0 units box\n";
+        }
+        if (numReplicas > 1) {
+            setup << "group bssReplica" << replica << " id " << replica * numNodes + 1 << ":" << (replica + 1) * numNodes << "\n"
+                  << "set group bssReplica" << replica << " mol " << replica + 1 << "\n";
+        }
+    }
+    if (numReplicas > 1) {
+        setup << "neigh_modify exclude molecule/inter all\n";
+    }
+    lammps_commands_string(handle, setup.str().c_str());
+    lammps_commands_string(handle, potential.c_str());
+    potentialCommands = potential;
+    // LAMMPS tests etol relative to the total energy, which grows with the number of replicas, so it is scaled down
+    // to stop when the energy of one replica changes as little as it would if that replica were minimised alone
+    std::ostringstream settings;
+    settings << "thermo 0\n"
+             << "thermo_style custom pe angles\n"
+             << "thermo_modify line yaml\n"
+             << "min_style sd\n"
+             << "variable etol equal " << 1.0e-6 / numReplicas << "\n"
+             << "variable ftol equal 0.0\n"
+             << "variable maxiter equal 1.0e6\n"
+             << "variable maxeval equal 1.0e7\n";
+    lammps_commands_string(handle, settings.str().c_str());
+    natoms = (int)(lammps_get_natoms(handle) + 0.5);
+
+    std::vector<int> networkBonds;
+    std::vector<int> networkAngles;
+    baseNetwork.getBondsAndAngles(networkBonds, networkAngles);
+    std::vector<int> packedBonds;
+    std::vector<int> packedAngles;
+    for (int replica = 0; replica < numReplicas; ++replica) {
+        for (const int &id : networkBonds) {
+            packedBonds.push_back(id + replica * numNodes);
+        }
+        for (const int &id : networkAngles) {
+            packedAngles.push_back(id + replica * numNodes);
+        }
+    }
+    rebuildTopology(packedBonds, packedAngles);
+    if (numReplicas > 1) {
+        // Replicas read their energies from this compute, so it is defined once here for every copy
+        lammps_command(handle, "compute bssAtomEnergy all pe/atom bond angle");
+        isAtomEnergyComputeDefined = true;
+    }
+    logger->debug("LAMMPS #nodes: {} #bonds: {} #angles: {}", natoms, nbonds, nangles);
+}
+
+/**
+ * @brief Get an object for one replica of an object holding several, which shares its instance and edits, reads
+ * and writes only the atoms of that replica. Minimising it minimises every replica.
+ * @param replica Index of the replica
+ * @param numReplicas The number of replicas held by this object
+ * @return The object for the replica
+ */
+LammpsObject LammpsObject::getReplica(const int &replica, const int &numReplicas) const {
+    LammpsObject replicaObject = *this;
+    replicaObject.natoms = natoms / numReplicas;
+    replicaObject.nbonds = nbonds / numReplicas;
+    replicaObject.nangles = nangles / numReplicas;
+    replicaObject.atomOffset = replica * replicaObject.natoms;
+    replicaObject.atomIDs.resize(replicaObject.natoms);
+    for (int i = 0; i < replicaObject.natoms; ++i) {
+        replicaObject.atomIDs[i] = replicaObject.atomOffset + i + 1;
+    }
+    return replicaObject;
+}
+
+/**
+ * @brief Free the LAMMPS instance, after which the object cannot be used. Copies share the instance,
+ * so this is only called by the owner of the last copy.
+ */
+void LammpsObject::close() {
+    if (handle != nullptr) {
+        lammps_close(handle);
+        handle = nullptr;
+    }
+}
+
+/**
+ * @brief Keep the LAMMPS instance open for the next object loaded from files, such as the next job run by the same
+ * process, after which this object cannot be used. Any instance released earlier and not yet reused is closed.
+ */
+void LammpsObject::release() {
+    if (handle == nullptr) {
+        return;
+    }
+    if (spareHandle != nullptr && spareHandle != handle) {
+        lammps_close(spareHandle);
+    }
+    spareHandle = handle;
+    handle = nullptr;
+}
+
 /**
  * @brief Exports the network to a file
 */
@@ -62,11 +221,11 @@ void LammpsObject::writeData() {
  * @param atom1 The first atom in the bond
  * @param atom2 The second atom in the bond
  * @param type The type of the bond
- * @throws std::runtime_error if the bond count doesn't decrease
+ * @throws std::runtime_error if verifying edits and the bond count doesn't decrease
 */
 void LammpsObject::breakBond(const int &atom1, const int &atom2, const int &type) {
     // logger->debug("Breaking bond between {} and {} of type {}", atom1, atom2, type);
-    double initialBondCount = lammps_get_thermo(handle, "bonds");
+    double initialBondCount = isVerifyingEdits ? lammps_get_thermo(handle, "bonds") : 0.0;
 
     std::string command = "group switch id " + std::to_string(atom1) + " " + std::to_string(atom2);
     lammps_command(handle, command.c_str());
@@ -77,6 +236,9 @@ void LammpsObject::breakBond(const int &atom1, const int &atom2, const int &type
 
     lammps_command(handle, "group switch delete");
 
+    if (!isVerifyingEdits) {
+        return;
+    }
     double finalBondCount = lammps_get_thermo(handle, "bonds");
     if (finalBondCount != initialBondCount - 1) {
         std::ostringstream oss;
@@ -91,14 +253,17 @@ void LammpsObject::breakBond(const int &atom1, const int &atom2, const int &type
  * @param atom1 The first atom in the bond
  * @param atom2 The second atom in the bond
  * @param type The type of the bond
- * @throws std::runtime_error if the bond count doesn't increase
+ * @throws std::runtime_error if verifying edits and the bond count doesn't increase
 */
 void LammpsObject::formBond(const int &atom1, const int &atom2, const int &type) {
     // logger->debug("Forming bond between {} and {} of type {}", atom1, atom2, type);
-    double initialBondCount = lammps_get_thermo(handle, "bonds");
+    double initialBondCount = isVerifyingEdits ? lammps_get_thermo(handle, "bonds") : 0.0;
     std::string command;
     command = "create_bonds single/bond " + std::to_string(type) + " " + std::to_string(atom1) + " " + std::to_string(atom2);
     lammps_command(handle, command.c_str());
+    if (!isVerifyingEdits) {
+        return;
+    }
     double finalBondCount = lammps_get_thermo(handle, "bonds");
     if (finalBondCount != initialBondCount + 1) {
         std::ostringstream oss;
@@ -109,14 +274,22 @@ void LammpsObject::formBond(const int &atom1, const int &atom2, const int &type)
 }
 
 /**
- * @brief Breaks an angle in the lattice by trying 1-2-3 first, then 3-2-1
+ * @brief Breaks an angle in the lattice by trying 1-2-3 first, then 3-2-1. Without verifying edits the angle is
+ * deleted once, so the other angles of a triangle of atoms are not restored.
  * @param atom1 The first atom in the angle
  * @param atom2 The second atom in the angle
  * @param atom3 The third atom in the angle
- * @throws std::runtime_error if the angle count doesn't decrease
+ * @throws std::runtime_error if verifying edits and the angle count doesn't decrease
  */
 void LammpsObject::breakAngle(const int &atom1, const int &atom2, const int &atom3) {
     // logger->debug("Breaking angle between {}, {}, {}", atom1, atom2, atom3);
+    if (!isVerifyingEdits) {
+        std::string command = "group switch id " + std::to_string(atom1) + " " + std::to_string(atom2) + " " + std::to_string(atom3);
+        lammps_command(handle, command.c_str());
+        lammps_command(handle, "delete_bonds switch angle 1 remove");
+        lammps_command(handle, "group switch delete");
+        return;
+    }
     double initialAngleCount = lammps_get_thermo(handle, "angles");
     double finalAngleCount;
     // Try to break the angle in both directions
@@ -191,6 +364,7 @@ void LammpsObject::breakAngle(const int &atom1, const int &atom2, const int &ato
  * @param atom1 The first atom in the angle
  * @param atom2 The second atom in the angle
  * @param atom3 The third atom in the angle
+ * @throws std::runtime_error if any atoms are the same, or if verifying edits and the angle count doesn't increase
  */
 void LammpsObject::formAngle(const int &atom1, const int &atom2, const int &atom3) {
     // logger->debug("Forming angle between {}, {}, {}", atom1, atom2, atom3);
@@ -199,10 +373,13 @@ void LammpsObject::formAngle(const int &atom1, const int &atom2, const int &atom
         oss << "Angle has one or more members that are the same ID: " << atom1 << " " << atom2 << " " << atom3;
         throw std::runtime_error(oss.str());
     }
-    double initialAngleCount = lammps_get_thermo(handle, "angles");
+    double initialAngleCount = isVerifyingEdits ? lammps_get_thermo(handle, "angles") : 0.0;
     std::string command;
     command = "create_bonds single/angle 1 " + std::to_string(atom1) + " " + std::to_string(atom2) + " " + std::to_string(atom3);
     lammps_command(handle, command.c_str());
+    if (!isVerifyingEdits) {
+        return;
+    }
     double finalAngleCount = lammps_get_thermo(handle, "angles");
     if (finalAngleCount != initialAngleCount + 1) {
         std::ostringstream oss;
@@ -222,20 +399,21 @@ void LammpsObject::formAngle(const int &atom1, const int &atom2, const int &atom
 void LammpsObject::switchGraphene(const std::vector<int> &bondBreaks, const std::vector<int> &bondMakes,
                                   const std::vector<int> &angleBreaks, const std::vector<int> &angleMakes,
                                   const std::vector<double> &rotatedCoord1, const std::vector<double> &rotatedCoord2) {
+    int firstID = atomOffset + 1;
     for (int i = 0; i < bondBreaks.size(); i += 2) {
-        breakBond(bondBreaks[i] + 1, bondBreaks[i + 1] + 1, 1);
+        breakBond(bondBreaks[i] + firstID, bondBreaks[i + 1] + firstID, 1);
     }
     for (int i = 0; i < bondMakes.size(); i += 2) {
-        formBond(bondMakes[i] + 1, bondMakes[i + 1] + 1, 1);
+        formBond(bondMakes[i] + firstID, bondMakes[i + 1] + firstID, 1);
     }
     for (int i = 0; i < angleBreaks.size(); i += 3) {
-        breakAngle(angleBreaks[i] + 1, angleBreaks[i + 1] + 1, angleBreaks[i + 2] + 1);
+        breakAngle(angleBreaks[i] + firstID, angleBreaks[i + 1] + firstID, angleBreaks[i + 2] + firstID);
     }
     for (int i = 0; i < angleMakes.size(); i += 3) {
-        formAngle(angleMakes[i] + 1, angleMakes[i + 1] + 1, angleMakes[i + 2] + 1);
+        formAngle(angleMakes[i] + firstID, angleMakes[i + 1] + firstID, angleMakes[i + 2] + firstID);
     }
-    int atom1ID = bondBreaks[0] + 1;
-    int atom2ID = bondBreaks[2] + 1;
+    int atom1ID = bondBreaks[0] + firstID;
+    int atom2ID = bondBreaks[2] + firstID;
     setAtomCoords(atom1ID, rotatedCoord1, 2);
     setAtomCoords(atom2ID, rotatedCoord2, 2);
 }
@@ -248,17 +426,18 @@ void LammpsObject::switchGraphene(const std::vector<int> &bondBreaks, const std:
  */
 void LammpsObject::revertGraphene(const std::vector<int> &bondBreaks, const std::vector<int> &bondMakes,
                                   const std::vector<int> &angleBreaks, const std::vector<int> &angleMakes) {
+    int firstID = atomOffset + 1;
     for (int i = 0; i < bondMakes.size(); i += 2) {
-        breakBond(bondMakes[i] + 1, bondMakes[i + 1] + 1, 1);
+        breakBond(bondMakes[i] + firstID, bondMakes[i + 1] + firstID, 1);
     }
     for (int i = 0; i < bondBreaks.size(); i += 2) {
-        formBond(bondBreaks[i] + 1, bondBreaks[i + 1] + 1, 1);
+        formBond(bondBreaks[i] + firstID, bondBreaks[i + 1] + firstID, 1);
     }
     for (int i = 0; i < angleMakes.size(); i += 3) {
-        breakAngle(angleMakes[i] + 1, angleMakes[i + 1] + 1, angleMakes[i + 2] + 1);
+        breakAngle(angleMakes[i] + firstID, angleMakes[i + 1] + firstID, angleMakes[i + 2] + firstID);
     }
     for (int i = 0; i < angleBreaks.size(); i += 3) {
-        formAngle(angleBreaks[i] + 1, angleBreaks[i + 1] + 1, angleBreaks[i + 2] + 1);
+        formAngle(angleBreaks[i] + firstID, angleBreaks[i + 1] + firstID, angleBreaks[i + 2] + firstID);
     }
 }
 
@@ -271,6 +450,10 @@ void LammpsObject::setCoords(std::vector<double> &newCoords, int dim) {
         oss << "Invalid size of newCoords, expected " << dim * natoms << " got " << newCoords.size();
         throw std::runtime_error(oss.str());
     }
+    if (!atomIDs.empty()) {
+        lammps_scatter_atoms_subset(handle, "x", 1, dim, natoms, atomIDs.data(), newCoords.data());
+        return;
+    }
     lammps_scatter_atoms(handle, "x", 1, dim, newCoords.data());
 }
 
@@ -284,9 +467,85 @@ void LammpsObject::setAtomCoords(const int &atomID, const std::vector<double> &n
         throw std::runtime_error(oss.str());
     }
     auto x = (double **)lammps_extract_atom(handle, "x");
+    int index = getLocalIndex(atomID);
     for (int i = 0; i < dim; i++) {
-        x[atomID - 1][i] = newCoords[i];
+        x[index][i] = newCoords[i];
+    }
+}
+
+/**
+ * @brief Get where an atom is stored in the per-atom arrays. LAMMPS reorders atoms when it sorts them
+ * spatially, so the index of an atom is not its ID - 1 after a minimisation.
+ * @param atomID The one-indexed ID of the atom
+ * @return The index of the atom in arrays from lammps_extract_atom
+ * @throws std::runtime_error if LAMMPS has no atom with the ID
+ */
+int LammpsObject::getLocalIndex(const int &atomID) const {
+    int index;
+    if (lammps_extract_setting(handle, "tagint") == 8) {
+        auto tag = static_cast<int64_t>(atomID);
+        index = lammps_map_atom(handle, &tag);
+    } else {
+        index = lammps_map_atom(handle, &atomID);
+    }
+    if (index < 0) {
+        throw std::runtime_error("LAMMPS has no atom with ID " + std::to_string(atomID));
+    }
+    return index;
+}
+
+/**
+ * @brief Set how often LAMMPS spatially sorts its atoms, which keeps neighbouring atoms close in memory
+ * @param interval Number of minimisation steps between sorts, 0 to never sort
+ */
+void LammpsObject::setAtomSortInterval(const int &interval) {
+    std::string command = "atom_modify sort " + std::to_string(interval) + " 0.0";
+    lammps_command(handle, command.c_str());
+}
+
+/**
+ * @brief Hold every atom outside an active region in place during minimisation, by zeroing the forces on them.
+ * Interactions whose atoms are all frozen never change, so they are removed from LAMMPS rather than evaluated on
+ * every minimiser iteration, and their energy is recorded once and added back by getPotentialEnergy and getAtomEnergies.
+ * @param activeNodeIDs IDs of the base nodes that may move
+ */
+void LammpsObject::freezeInactiveAtoms(const std::vector<int> &activeNodeIDs) {
+    std::string command = "group bssActive id";
+    for (const int &id : activeNodeIDs) {
+        command += " " + std::to_string(atomOffset + id + 1);
+    }
+    lammps_command(handle, command.c_str());
+    lammps_command(handle, "group bssFrozen subtract all bssActive");
+    lammps_command(handle, "fix bssFreeze bssFrozen setforce 0.0 0.0 0.0");
+
+    std::vector<double> allAtomEnergies;
+    getAtomEnergies(allAtomEnergies);
+    double totalEnergy = lammps_get_thermo(handle, "pe");
+    lammps_command(handle, "neigh_modify exclude group bssFrozen bssFrozen");
+    lammps_command(handle, "delete_bonds bssFrozen multi remove special");
+    std::vector<double> remainingAtomEnergies;
+    getAtomEnergies(remainingAtomEnergies);
+    frozenEnergy = totalEnergy - lammps_get_thermo(handle, "pe");
+    frozenAtomEnergies.resize(allAtomEnergies.size());
+    for (size_t i = 0; i < allAtomEnergies.size(); ++i) {
+        frozenAtomEnergies[i] = allAtomEnergies[i] - remainingAtomEnergies[i];
     }
+    isFrozenAtom.assign(natoms, true);
+    for (const int &id : activeNodeIDs) {
+        isFrozenAtom[id] = false;
+    }
+    nbonds = static_cast<int>(lammps_get_thermo(handle, "bonds"));
+    nangles = static_cast<int>(lammps_get_thermo(handle, "angles"));
+    logger->debug("Removed the bonds and angles between frozen atoms from LAMMPS, leaving {} bonds and {} angles", nbonds, nangles);
+}
+
+/**
+ * @brief Check whether every atom of a bond or angle is frozen, in which case it is not held by LAMMPS
+ * @param atoms Zero-indexed IDs of the atoms
+ * @return True if every atom is frozen
+ */
+bool LammpsObject::isFrozen(const std::vector<int> &atoms) const {
+    return !isFrozenAtom.empty() && std::all_of(atoms.begin(), atoms.end(), [this](const int &id) { return isFrozenAtom[id] != 0; });
 }
 
 /**
@@ -311,11 +570,97 @@ void LammpsObject::stopMovie() {
 
 /**
  * @brief Minimise the potential energy of the network by moving atoms
+ * @return The number of minimiser iterations
  */
-void LammpsObject::minimiseNetwork() {
+int LammpsObject::minimiseNetwork() {
+    // Minimisation advances the timestep by one per iteration
+    double initialStep = lammps_get_thermo(handle, "step");
     // Numbers are stopping tolerance for energy, stopping tolerance for force,
     // maximum number of iterations and maximum number of energy/force evaluations
     lammps_command(handle, "minimize ${etol} ${ftol} ${maxiter} ${maxeval}");
+    return static_cast<int>(lammps_get_thermo(handle, "step") - initialStep);
+}
+
+/**
+ * @brief Set the minimiser used by minimiseNetwork
+ * @param minStyle The LAMMPS min_style, such as sd, cg or fire
+ * @param energyTolerance The relative change in energy at which minimisation stops
+ */
+void LammpsObject::setMinimiser(const std::string &minStyle, const double &energyTolerance) {
+    std::ostringstream commands;
+    commands << "min_style " << minStyle << "\n"
+             << "variable etol equal " << energyTolerance << "\n";
+    lammps_commands_string(handle, commands.str().c_str());
+}
+
+/**
+ * @brief Compute forces on several threads with the omp styles of the OPENMP package. The potential commands
+ * are reissued so that the bond and angle styles are replaced by their omp versions.
+ * @param numThreads The number of threads, 1 to use the plain styles
+ * @throws std::runtime_error if the potential commands are not known
+ */
+void LammpsObject::setNumThreads(const int &numThreads) {
+    if (potentialCommands.empty()) {
+        throw std::runtime_error("Cannot change the number of LAMMPS threads without the potential commands");
+    }
+    if (numThreads > 1) {
+        std::string command = "package omp " + std::to_string(numThreads);
+        lammps_command(handle, command.c_str());
+        lammps_command(handle, "suffix omp");
+    } else {
+        lammps_command(handle, "suffix off");
+    }
+    lammps_commands_string(handle, potentialCommands.c_str());
+}
+
+/**
+ * @brief Check if LAMMPS was built with the OPENMP package
+ * @return true if the omp styles are available, false otherwise
+ */
+bool LammpsObject::hasOpenMP() const {
+    return lammps_config_has_package("OPENMP") != 0;
+}
+
+/**
+ * @brief Replace every bond and angle in the network using zero-indexed node IDs, for when many switches
+ * have been made to the BSS network without LAMMPS. The special lists are only rebuilt once, by the last angle.
+ * @param topologyBonds The IDs of every bond (1D vector of pairs)
+ * @param topologyAngles The IDs of every angle (1D vector of triples)
+ * @param isFrozenSkipped Leave out the bonds and angles whose atoms are all frozen, false to create every one
+ * @throws std::runtime_error if the bond or angle counts do not match afterwards
+ */
+void LammpsObject::rebuildTopology(const std::vector<int> &topologyBonds, const std::vector<int> &topologyAngles,
+                                   const bool &isFrozenSkipped) {
+    std::vector<int> keptBonds;
+    std::vector<int> keptAngles;
+    for (size_t i = 0; i < topologyBonds.size(); i += 2) {
+        if (!isFrozenSkipped || !isFrozen({topologyBonds[i], topologyBonds[i + 1]})) {
+            keptBonds.insert(keptBonds.end(), topologyBonds.begin() + i, topologyBonds.begin() + i + 2);
+        }
+    }
+    for (size_t i = 0; i < topologyAngles.size(); i += 3) {
+        if (!isFrozenSkipped || !isFrozen({topologyAngles[i], topologyAngles[i + 1], topologyAngles[i + 2]})) {
+            keptAngles.insert(keptAngles.end(), topologyAngles.begin() + i, topologyAngles.begin() + i + 3);
+        }
+    }
+    lammps_command(handle, "delete_bonds all multi remove special");
+    std::string command;
+    for (int i = 0; i < keptBonds.size(); i += 2) {
+        command = "create_bonds single/bond 1 " + std::to_string(keptBonds[i] + 1) + " " + std::to_string(keptBonds[i + 1] + 1) + " special no";
+        lammps_command(handle, command.c_str());
+    }
+    for (int i = 0; i < keptAngles.size(); i += 3) {
+        command = "create_bonds single/angle 1 " + std::to_string(keptAngles[i] + 1) + " " + std::to_string(keptAngles[i + 1] + 1) + " " +
+                  std::to_string(keptAngles[i + 2] + 1) + (i + 3 < keptAngles.size() ? " special no" : " special yes");
+        lammps_command(handle, command.c_str());
+    }
+    nbonds = keptBonds.size() / 2;
+    nangles = keptAngles.size() / 3;
+    if (lammps_get_thermo(handle, "bonds") != nbonds || lammps_get_thermo(handle, "angles") != nangles) {
+        std::ostringstream oss;
+        oss << "Error in counts while rebuilding topology, expected " << nbonds << " bonds and " << nangles << " angles";
+        throw std::runtime_error(oss.str());
+    }
 }
 
 /**
@@ -323,7 +668,48 @@ void LammpsObject::minimiseNetwork() {
  * @return The potential energy of the network
  */
 double LammpsObject::getPotentialEnergy() {
-    return lammps_get_thermo(handle, "pe");
+    if (!atomIDs.empty()) {
+        std::vector<double> atomEnergies;
+        getAtomEnergies(atomEnergies);
+        return std::accumulate(atomEnergies.begin(), atomEnergies.end(), 0.0);
+    }
+    return lammps_get_thermo(handle, "pe") + frozenEnergy;
+}
+
+/**
+ * @brief Get the potential energy of the network at its current coordinates, which are evaluated once more without
+ * moving any atoms, for when they have been set rather than reached by minimisation
+ * @return The potential energy of the network
+ */
+double LammpsObject::evaluatePotentialEnergy() {
+    lammps_command(handle, "run 0 post no");
+    return getPotentialEnergy();
+}
+
+/**
+ * @brief Get the potential energy of each atom, with every bond split equally between its two atoms and every
+ * angle between its three atoms. Per-atom energies are only tallied on timesteps that ask for them, so the
+ * current configuration is evaluated once more without moving any atoms.
+ * @param atomEnergies Vector to hold the energy of each atom, in order of atom ID
+ */
+void LammpsObject::getAtomEnergies(std::vector<double> &atomEnergies) {
+    if (!isAtomEnergyComputeDefined) {
+        lammps_command(handle, "compute bssAtomEnergy all pe/atom bond angle");
+        isAtomEnergyComputeDefined = true;
+    }
+    lammps_command(handle, "run 0 post no");
+    if (!atomIDs.empty()) {
+        // Gathered in order of atom ID, so the atoms of this replica are contiguous
+        std::vector<double> allAtomEnergies(static_cast<size_t>(lammps_get_natoms(handle) + 0.5));
+        lammps_gather(handle, "c_bssAtomEnergy", 1, 1, allAtomEnergies.data());
+        atomEnergies.assign(allAtomEnergies.begin() + atomOffset, allAtomEnergies.begin() + atomOffset + natoms);
+        return;
+    }
+    atomEnergies.resize(natoms);
+    lammps_gather(handle, "c_bssAtomEnergy", 1, 1, atomEnergies.data());
+    for (size_t i = 0; i < frozenAtomEnergies.size(); ++i) {
+        atomEnergies[i] += frozenAtomEnergies[i];
+    }
 }
 
 /**
@@ -336,11 +722,47 @@ std::vector<double> LammpsObject::getCoords(const int &dim) const {
         throw std::runtime_error("Invalid dimension");
     }
     // Get the coordinates of the atoms
-    std::vector<double> coords(dim * natoms);
-    lammps_gather_atoms(handle, "x", 1, dim, coords.data());
+    std::vector<double> coords;
+    getCoords(coords, dim);
     return coords;
 }
 
+/**
+ * @brief Get the coordinates of the atoms in the network without allocating if coords is already the right size
+ * @param coords Vector to hold the coordinates of the atoms as a 1D vector
+ * @param dim the number of dimensions you want to receieve, 2 or 3
+ */
+void LammpsObject::getCoords(std::vector<double> &coords, const int &dim) const {
+    if (dim != 2 && dim != 3) {
+        throw std::runtime_error("Invalid dimension");
+    }
+    coords.resize(dim * natoms);
+    if (!atomIDs.empty()) {
+        lammps_gather_atoms_subset(handle, "x", 1, dim, natoms, const_cast<int *>(atomIDs.data()), coords.data());
+        return;
+    }
+    lammps_gather_atoms(handle, "x", 1, dim, coords.data());
+}
+
+/**
+ * @brief Gets all the bonds in the system
+ * @return A 1D vector containing all the bonds in the system in the form [b1atom1, b1atom2, b2atom1, b2atom2, ...]
+ */
+std::vector<int> LammpsObject::getBonds() const {
+    lammps_command(handle, "compute myBonds all property/local batom1 batom2");
+    auto compute_output = (double **)lammps_extract_compute(handle, "myBonds", 2, 2);
+    int numBonds = *static_cast<int *>(lammps_extract_compute(handle, "myBonds", 2, 4));
+
+    std::vector<int> bondAtoms(numBonds * 2);
+    for (int i = 0; i < numBonds; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            bondAtoms[i * 2 + j] = static_cast<int>(compute_output[i][j]);
+        }
+    }
+    lammps_command(handle, "uncompute myBonds");
+    return bondAtoms;
+}
+
 /**
  * @brief Gets all the angles in the system
  * @return A 1D vector containing all the angles in the system in the form [a1atom1, a1atom2, a1atom3, a2atom1, a2atom2, a2atom3, ...]
@@ -1,4 +1,5 @@
 #include "linked_network.h"
+#include <array>
 #include <filesystem>
 
 /**
@@ -12,49 +13,180 @@ LinkedNetwork::LinkedNetwork() = default;
  * @param inputData the input data object
  * @param loggerArg the logger object
  */
-LinkedNetwork::LinkedNetwork(const InputData &inputData, const LoggerPtr &loggerArg) : minRingSize(inputData.minRingSize),
-                                                                                       maxRingSize(inputData.maxRingSize),
-                                                                                       selectionType(inputData.randomOrWeighted),
-                                                                                       metropolisCondition(inputData.randomSeed),
-                                                                                       weightedDecay(inputData.weightedDecay),
-                                                                                       maximumBondLength(inputData.maximumBondLength),
-                                                                                       maximumAngle(inputData.maximumAngle * M_PI / 180),
-                                                                                       writeMovie(inputData.writeMovie),
-                                                                                       logger(loggerArg) {
-    networkA = Network(NetworkType::BASE_NETWORK, logger);
-    networkB = Network(NetworkType::DUAL_NETWORK, logger);
+LinkedNetwork::LinkedNetwork(const InputData &inputData, const LoggerPtr &loggerArg) : LinkedNetwork(inputData, nullptr, "", loggerArg) {
+}
 
+/**
+ * @brief Construct from a base network in memory, or by loading networks from files
+ * @param inputData the input data object
+ * @param baseNetwork the base network to start from, whose rings are derived and which is built in LAMMPS directly,
+ * or nullptr to load the networks and LAMMPS files from ./input_files
+ * @param potential LAMMPS commands setting up the potential if baseNetwork is given, like lammps_potential.txt
+ * @param loggerArg the logger object
+ */
+LinkedNetwork::LinkedNetwork(const InputData &inputData, const Network *baseNetwork, const std::string &potential,
+                             const LoggerPtr &loggerArg)
+    : minRingSize(inputData.minRingSize),
+      maxRingSize(inputData.maxRingSize),
+      selectionType(inputData.randomOrWeighted),
+      metropolisCondition(inputData.randomSeed),
+      weightedDecay(inputData.weightedDecay),
+      maximumBondLength(inputData.maximumBondLength),
+      maximumAngle(inputData.maximumAngle * M_PI / 180),
+      writeMovie(inputData.writeMovie),
+      topologyCache(inputData.topologyCacheSize, inputData.isLeanMemory),
+      skipRelaxationOnCacheHit(inputData.skipRelaxationOnCacheHit),
+      reuseProposalOutcomes(inputData.reuseProposalOutcomes),
+      pipelineProposals(inputData.pipelineProposals),
+      isLeanMemory(inputData.isLeanMemory),
+      relaxationTemplates(inputData.useRelaxationTemplates),
+      topologyOnlyTemperature(std::pow(10, inputData.topologyOnlyTemperature)),
+      topologyOnlyRelaxInterval(inputData.topologyOnlyRelaxInterval),
+      switchBatchSize(inputData.switchBatchSize),
+      batchRegionRadius(inputData.batchRegionRadius),
+      topologyAuditInterval(inputData.topologyAuditInterval),
+      ringAreaTolerance(inputData.ringAreaTolerance),
+      logger(loggerArg) {
+    if (baseNetwork != nullptr) {
+        networkA = *baseNetwork;
+        networkB = networkA.deriveRingNetwork();
+    } else if (inputData.deriveRingNetwork) {
+        networkA = Network(std::filesystem::path("./input_files") / "bss_network", NetworkType::BASE_NETWORK, false, logger);
+        networkB = networkA.deriveRingNetwork();
+        logger->info("Derived {} rings from the base network", networkB.nodes.size());
+        if (inputData.isFixRingsEnabled) {
+            logger->warn("Fixed ring IDs refer to the derived ring network, which is written to output_files");
+        }
+    } else {
+        networkA = Network(NetworkType::BASE_NETWORK, logger);
+        networkB = Network(NetworkType::DUAL_NETWORK, logger);
+    }
+    if (inputData.nodeOrdering != NodeOrdering::ORIGINAL) {
+        renumberNodes(inputData.nodeOrdering);
+    }
+
+    fixedRingSizes.assign(networkB.nodes.size(), 0);
+    isFixedNode.assign(networkA.nodes.size(), false);
     if (inputData.isFixRingsEnabled) {
         findFixedRings(std::filesystem::path("./input_files") / "bss_network" /"fixed_rings.txt");
         findFixedNodes();
     } else {
         logger->info("Fixed rings disabled, setting number of fixed rings to 0.");
     }
+    if (inputData.activeRegion != ActiveRegion::NONE) {
+        findActiveNodes(inputData.activeRegion, inputData.activeRegionShells, inputData.activeRegionRadius);
+    }
     if (int loadedMinRingSize = networkB.getMinConnections(); loadedMinRingSize < minRingSize) {
         logger->warn("Loaded network has a min ring size of {} which is lower than input file's {}", loadedMinRingSize, minRingSize);
     }
     if (int loadedMaxRingSize = networkB.getMaxConnections(); loadedMaxRingSize > maxRingSize) {
         logger->warn("Loaded network has a max ring size of {} which is higher than input file's {}", loadedMaxRingSize, maxRingSize);
     }
+    if (switchBatchSize > 1 && (topologyCache.isEnabled() || reuseProposalOutcomes || pipelineProposals || relaxationTemplates.isEnabled)) {
+        logger->warn("The topology cache, proposal reuse, pipelining and relaxation templates are not used with {} switches per relaxation", switchBatchSize);
+    }
     dimensions = networkA.dimensions;
     centreCoords = {dimensions[0] / 2, dimensions[1] / 2};
-
-    lammpsNetwork = LammpsObject(logger);
+    if (isLeanMemory) {
+        networkA.shrinkToFit();
+        networkB.shrinkToFit();
+    }
+    mesh = HalfEdgeMesh(networkA, networkB);
+    heatmap = SwitchHeatmap(inputData.heatmapGridSize, dimensions);
+
+    lammpsNetwork = baseNetwork != nullptr ? LammpsObject(networkA, potential, logger) : LammpsObject(logger);
+    lammpsNetwork.setAtomSortInterval(inputData.atomSortInterval);
+    lammpsNetwork.isVerifyingEdits = topologyAuditInterval == 0;
+    if (baseNetwork == nullptr && !baseNodeOrder.empty()) {
+        // LAMMPS read the data file with the original IDs
+        std::vector<double> coords;
+        coords.reserve(2 * networkA.nodes.size());
+        for (const Node &node : networkA.nodes) {
+            coords.insert(coords.end(), node.crd.begin(), node.crd.end());
+        }
+        std::vector<int> bonds;
+        std::vector<int> angles;
+        networkA.getBondsAndAngles(bonds, angles);
+        lammpsNetwork.setCoords(coords, 2);
+        lammpsNetwork.rebuildTopology(bonds, angles);
+    }
+    // Frozen after renumbering, as atoms are grouped and their interactions removed by atom ID
+    if (!activeNodes.empty()) {
+        lammpsNetwork.freezeInactiveAtoms(activeNodes);
+    }
     if (writeMovie) {
-        lammpsNetwork.startMovie();
-        lammpsNetwork.writeMovie();
+        if (inputData.movieRenderer == MovieRenderer::NATIVE) {
+            int numRenderThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 4);
+            frameRenderer = std::make_unique<FrameRenderer>(std::filesystem::path("./output_files") / "movie_frames", dimensions,
+                                                            inputData.colourRingsInMovie, numRenderThreads);
+        } else {
+            lammpsNetwork.startMovie();
+        }
+        writeMovieFrame();
     }
     lammpsNetwork.minimiseNetwork();
     currentCoords = lammpsNetwork.getCoords(2);
     energy = lammpsNetwork.getPotentialEnergy();
+    topologyHash = computeTopologyHash();
+    topologyCache.insert(topologyHash, energy, currentCoords);
     pushCoords(currentCoords);
-    weights.resize(networkA.nodes.size());
+    if (!isLeanMemory || selectionType != SelectionType::RANDOM) {
+        weights.resize(networkA.nodes.size());
+    }
     updateWeights();
+    if (inputData.autotuneMoves > 0) {
+        autotuneLammps(inputData.autotuneMoves, inputData.autotuneEnergyTolerance);
+    }
     randomNumGen.seed(inputData.randomSeed);
+    logMemoryUsage();
 }
 
 /**
- * @brief read the fixed_rings.txt file and populate fixedRings with integers from each line
+ * @brief Construct a replica of a loaded network in a packed LAMMPS instance, copying its networks, coordinates
+ * and energy rather than reading the input files and starting and minimising LAMMPS again
+ * @param source the loaded network, whose settings must allow packed replicas
+ * @param replicaObject view of this replica's atoms in the packed LAMMPS instance
+ */
+LinkedNetwork::LinkedNetwork(const LinkedNetwork &source, const LammpsObject &replicaObject)
+    : networkB(source.networkB),
+      minRingSize(source.minRingSize),
+      maxRingSize(source.maxRingSize),
+      networkA(source.networkA),
+      mesh(source.mesh),
+      dimensions(source.dimensions),
+      centreCoords(source.centreCoords),
+      energy(source.energy),
+      currentCoords(source.currentCoords),
+      isOpenMPIEnabled(source.isOpenMPIEnabled),
+      selectionType(source.selectionType),
+      randomNumGen(source.randomNumGen),
+      metropolisCondition(source.metropolisCondition),
+      weightedDecay(source.weightedDecay),
+      maximumBondLength(source.maximumBondLength),
+      maximumAngle(source.maximumAngle),
+      writeMovie(false),
+      fixedRingSizes(source.fixedRingSizes),
+      isFixedNode(source.isFixedNode),
+      isActiveNode(source.isActiveNode),
+      activeNodes(source.activeNodes),
+      topologyHash(source.topologyHash),
+      isLeanMemory(source.isLeanMemory),
+      topologyOnlyTemperature(source.topologyOnlyTemperature),
+      topologyOnlyRelaxInterval(source.topologyOnlyRelaxInterval),
+      switchBatchSize(source.switchBatchSize),
+      batchRegionRadius(source.batchRegionRadius),
+      ringAreaTolerance(source.ringAreaTolerance),
+      heatmap(source.heatmap),
+      baseNodeOrder(source.baseNodeOrder),
+      ringNodeOrder(source.ringNodeOrder),
+      logger(source.logger),
+      weights(source.weights),
+      nodeDistribution(source.nodeDistribution) {
+    usePackedLammps(replicaObject);
+}
+
+/**
+ * @brief read the fixed_rings.txt file and record the size of the ring given on each line in fixedRingSizes
  * @param isFixedRingsEnabled boolean to enable or disable fixed rings
  * @param filename the name of the input file
  */
@@ -66,135 +198,1042 @@ void LinkedNetwork::findFixedRings(const std::string &filePath) {
         logger->warn("Failed to open file: {}, setting number of fixed rings to 0 and they will be ignored", filePath);
         return;
     }
+    std::vector<int> newRingIDs = invertPermutation(ringNodeOrder);
     std::string line;
+    int numFixedRings = 0;
+    std::ostringstream fixedRingInfo;
     while (std::getline(fixedRingsFile, line)) {
         int num;
         std::istringstream(line) >> num;
-        fixedRings[num] = networkB.nodes[num].netConnections.size();
+        if (!newRingIDs.empty()) {
+            num = newRingIDs[num];
+        }
+        if (fixedRingSizes[num] == 0) {
+            numFixedRings++;
+            fixedRingInfo << num << ": " << networkB.nodes[num].netConnections.size() << " ";
+        }
+        fixedRingSizes[num] = networkB.nodes[num].netConnections.size();
+    }
+    logger->info("Number of fixed rings: {}", numFixedRings);
+    logger->info("Fixed ring info (ID: Size): {}", fixedRingInfo.str());
+}
+
+/**
+ * @brief Renumber the nodes and rings so that neighbours have close IDs, which keeps walks over the networks
+ * in cache. The original IDs are kept for reading fixed rings and writing output files.
+ * @param nodeOrdering How to order the nodes and rings
+ */
+void LinkedNetwork::renumberNodes(const NodeOrdering &nodeOrdering) {
+    if (nodeOrdering == NodeOrdering::HILBERT) {
+        baseNodeOrder = networkA.getHilbertOrder();
+        ringNodeOrder = networkB.getHilbertOrder();
+    } else {
+        baseNodeOrder = networkA.getCuthillMcKeeOrder();
+        ringNodeOrder = networkB.getCuthillMcKeeOrder();
     }
-    logger->info("Number of fixed rings: {}", fixedRings.size());
-    logger->info("Fixed ring info (ID: Size): {}", mapToString(fixedRings));
+    networkA.renumber(baseNodeOrder, ringNodeOrder);
+    networkB.renumber(ringNodeOrder, baseNodeOrder);
+    logger->info("Renumbered {} nodes and {} rings", networkA.nodes.size(), networkB.nodes.size());
 }
 
 /**
- * @brief Populate fixedNodes with all base nodes that are a member of all fixed rings
+ * @brief Time LAMMPS minimiser settings on calibration moves from the current network and keep the fastest whose
+ * relaxed energies agree with the default settings. The minimiser style is tuned first, then the energy tolerance,
+ * then the number of OpenMP threads. Every calibration move is undone, so the network is left as it was.
+ * @param numMoves The number of calibration moves relaxed under every candidate
+ * @param energyTolerance The largest difference from the default relaxed energy of any move, in Hartrees
+ */
+void LinkedNetwork::autotuneLammps(const int &numMoves, const double &energyTolerance) {
+    logger->info("Autotuning LAMMPS on {} calibration moves...", numMoves);
+    std::vector<SwitchMove> moves;
+    moves.reserve(numMoves);
+    for (int i = 0; i < numMoves; ++i) {
+        moves.push_back(findSwitchMove());
+    }
+
+    int appliedThreads = 1;
+    auto calibrate = [this, &moves, &appliedThreads](const std::string &minStyle, const double &tolerance, const int &numThreads,
+                                                     std::vector<double> &relaxedEnergies) {
+        lammpsNetwork.setMinimiser(minStyle, tolerance);
+        if (numThreads != appliedThreads) {
+            lammpsNetwork.setNumThreads(numThreads);
+            appliedThreads = numThreads;
+        }
+        relaxedEnergies.clear();
+        auto start = std::chrono::steady_clock::now();
+        for (const SwitchMove &move : moves) {
+            lammpsNetwork.switchGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes, move.rotatedCoord1, move.rotatedCoord2);
+            lammpsNetwork.minimiseNetwork();
+            relaxedEnergies.push_back(lammpsNetwork.getPotentialEnergy());
+            lammpsNetwork.revertGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes);
+            lammpsNetwork.setCoords(currentCoords, 2);
+        }
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        return duration.count() / moves.size();
+    };
+
+    std::vector<double> defaultEnergies;
+    std::string bestStyle = "sd";
+    double bestTolerance = 1.0e-6;
+    int bestThreads = 1;
+    double bestTime = calibrate(bestStyle, bestTolerance, bestThreads, defaultEnergies);
+    logger->info("Autotune {} etol {:.0e} on 1 thread: {:.3f} ms per move", bestStyle, bestTolerance, bestTime);
+
+    std::vector<double> relaxedEnergies;
+    auto tryCandidate = [&](const std::string &minStyle, const double &tolerance, const int &numThreads) {
+        double time = calibrate(minStyle, tolerance, numThreads, relaxedEnergies);
+        double maxDifference = 0.0;
+        for (int i = 0; i < relaxedEnergies.size(); ++i) {
+            maxDifference = std::max(maxDifference, std::abs(relaxedEnergies[i] - defaultEnergies[i]));
+        }
+        bool isAgreed = maxDifference <= energyTolerance;
+        logger->info("Autotune {} etol {:.0e} on {} threads: {:.3f} ms per move, energies differ by up to {:.2e} Eh{}",
+                     minStyle, tolerance, numThreads, time, maxDifference, isAgreed ? "" : ", rejected");
+        if (isAgreed && time < bestTime) {
+            bestStyle = minStyle;
+            bestTolerance = tolerance;
+            bestThreads = numThreads;
+            bestTime = time;
+        }
+    };
+    for (const char *minStyle : {"cg", "fire"}) {
+        tryCandidate(minStyle, 1.0e-6, 1);
+    }
+    for (const double &tolerance : {1.0e-5, 1.0e-4}) {
+        tryCandidate(bestStyle, tolerance, 1);
+    }
+    if (lammpsNetwork.hasOpenMP()) {
+        for (int numThreads = 2; numThreads <= omp_get_max_threads(); numThreads *= 2) {
+            tryCandidate(bestStyle, bestTolerance, numThreads);
+        }
+    }
+
+    lammpsNetwork.setMinimiser(bestStyle, bestTolerance);
+    if (bestThreads != appliedThreads) {
+        lammpsNetwork.setNumThreads(bestThreads);
+    }
+    logger->info("Autotune chose {} etol {:.0e} on {} threads, {:.3f} ms per move", bestStyle, bestTolerance, bestThreads, bestTime);
+}
+
+/**
+ * @brief Get copies of the networks with their original IDs, undoing any renumbering
+ * @param baseNetwork Network to hold the base network
+ * @param ringNetwork Network to hold the ring network
+ */
+void LinkedNetwork::getOriginalNetworks(Network &baseNetwork, Network &ringNetwork) const {
+    baseNetwork = networkA;
+    ringNetwork = networkB;
+    if (!baseNodeOrder.empty()) {
+        std::vector<int> newBaseIDs = invertPermutation(baseNodeOrder);
+        std::vector<int> newRingIDs = invertPermutation(ringNodeOrder);
+        baseNetwork.renumber(newBaseIDs, newRingIDs);
+        ringNetwork.renumber(newRingIDs, newBaseIDs);
+    }
+}
+
+/**
+ * @brief Flag in isFixedNode all base nodes that are a member of any fixed ring
  */
 void LinkedNetwork::findFixedNodes() {
-    std::for_each(fixedRings.begin(), fixedRings.end(), [this](const std::pair<const int, int> &fixedRingPair) {
-        int fixedRing = fixedRingPair.first;
-        std::for_each(networkB.nodes[fixedRing].dualConnections.begin(), networkB.nodes[fixedRing].dualConnections.end(), [this](int fixedNode) {
-            fixedNodes.insert(fixedNode);
-        });
-    });
+    for (int ringID = 0; ringID < networkB.nodes.size(); ++ringID) {
+        if (fixedRingSizes[ringID] == 0) {
+            continue;
+        }
+        for (const int &nodeID : networkB.nodes[ringID].dualConnections) {
+            isFixedNode[nodeID] = true;
+        }
+    }
 }
 
 /**
- * @brief Perform a monte carlo switch move, evaluate energy, and accept or reject
+ * @brief Flag in isActiveNode the base nodes around the fixed rings that switches may move, and list them in
+ * activeNodes. Every other node is frozen.
+ * @param activeRegion How the region is measured from the fixed rings
+ * @param numShells Shells of rings beyond the fixed rings whose nodes are active, if measured in shells. A node is
+ * active if all of its rings are within this many shells, so switches never change the size of a ring outside them
+ * @param radius Distance from the centre of a fixed ring within which nodes are active, if measured by radius
+ * @throw std::runtime_error if the region contains no nodes
  */
-void LinkedNetwork::monteCarloSwitchMoveLAMMPS(const double &temperature) {
-    logger->debug("Finding move...");
-    bool foundValidMove = false;
-    int baseNode1;
-    int baseNode2;
-    int ringNode1;
-    int ringNode2;
-
-    std::vector<int> bondBreaks;
-    std::vector<int> bondMakes;
-    std::vector<int> angleBreaks;
-    std::vector<int> angleMakes;
-    std::vector<int> ringBondBreakMake;
-    std::unordered_set<int> involvedNodes;
+void LinkedNetwork::findActiveNodes(const ActiveRegion &activeRegion, const int &numShells, const double &radius) {
+    isActiveNode.assign(networkA.nodes.size(), false);
+    if (activeRegion == ActiveRegion::SHELLS) {
+        // Breadth first search over the ring network from every fixed ring at once
+        std::vector<int> ringShells(networkB.nodes.size(), -1);
+        std::vector<int> frontier;
+        for (int ringID = 0; ringID < networkB.nodes.size(); ++ringID) {
+            if (fixedRingSizes[ringID] > 0) {
+                ringShells[ringID] = 0;
+                frontier.push_back(ringID);
+            }
+        }
+        std::vector<int> nextFrontier;
+        for (int shell = 1; shell <= numShells && !frontier.empty(); ++shell) {
+            nextFrontier.clear();
+            for (const int &ringID : frontier) {
+                for (const int &neighbourID : networkB.nodes[ringID].netConnections) {
+                    if (ringShells[neighbourID] < 0) {
+                        ringShells[neighbourID] = shell;
+                        nextFrontier.push_back(neighbourID);
+                    }
+                }
+            }
+            frontier.swap(nextFrontier);
+        }
+        for (int nodeID = 0; nodeID < networkA.nodes.size(); ++nodeID) {
+            const std::vector<int> &rings = networkA.nodes[nodeID].dualConnections;
+            isActiveNode[nodeID] = std::all_of(rings.begin(), rings.end(), [&ringShells](const int &ringID) { return ringShells[ringID] >= 0; });
+        }
+    } else if (activeRegion == ActiveRegion::RADIUS) {
+        for (int ringID = 0; ringID < networkB.nodes.size(); ++ringID) {
+            if (fixedRingSizes[ringID] == 0) {
+                continue;
+            }
+            for (int nodeID = 0; nodeID < networkA.nodes.size(); ++nodeID) {
+                std::vector<double> separation = pbcVector(networkB.nodes[ringID].crd, networkA.nodes[nodeID].crd, networkA.dimensions);
+                if (std::hypot(separation[0], separation[1]) <= radius) {
+                    isActiveNode[nodeID] = true;
+                }
+            }
+        }
+    }
+    for (int nodeID = 0; nodeID < networkA.nodes.size(); ++nodeID) {
+        if (isActiveNode[nodeID]) {
+            activeNodes.push_back(nodeID);
+        }
+    }
+    if (activeNodes.empty()) {
+        throw std::runtime_error("The active region contains no nodes");
+    }
+    logger->info("Active region: {} of {} nodes, the rest are frozen", activeNodes.size(), networkA.nodes.size());
+}
+
+/**
+ * @brief Check whether switches may move a base node
+ * @param nodeID ID of the base node
+ * @return true if there is no active region or the node is inside it, false otherwise
+ */
+bool LinkedNetwork::isNodeActive(const int &nodeID) const {
+    return isActiveNode.empty() || isActiveNode[nodeID];
+}
+
+/**
+ * @brief Get the base nodes that are not a member of any fixed ring
+ * @param nodeIDs IDs of the base nodes to filter
+ * @return IDs of the nodes in nodeIDs that are not fixed
+ */
+std::unordered_set<int> LinkedNetwork::getUnfixedNodes(const std::unordered_set<int> &nodeIDs) const {
+    std::unordered_set<int> unfixedNodes;
+    for (const int &nodeID : nodeIDs) {
+        if (!isFixedNode[nodeID]) {
+            unfixedNodes.insert(nodeID);
+        }
+    }
+    return unfixedNodes;
+}
 
+/**
+ * @brief Find a random valid switch move in the current network
+ * @return The switch move with its bond and angle operations and the rotated coordinates of the bond
+ * @throw std::runtime_error if no valid switch move can be found
+ */
+SwitchMove LinkedNetwork::findSwitchMove() {
+    logger->debug("Finding move...");
+    SwitchMove move;
+    move.epoch = acceptanceEpoch;
     for (int i = 0; i < networkA.nodes.size() * networkA.nodes.size(); ++i) {
-        std::tuple<int, int, int, int> result;
-        result = pickRandomConnection();
+        std::tie(move.baseNode1, move.baseNode2, move.ringNode1, move.ringNode2) = pickRandomConnection();
+        logger->debug("Picked base nodes: {} {} and ring nodes: {} {}", move.baseNode1, move.baseNode2, move.ringNode1, move.ringNode2);
+        if (pipelineProposals) {
+            // Everything genSwitchOperations reads is within the neighbourhood of the picked bond
+            for (const int &id : {move.baseNode1, move.baseNode2}) {
+                move.examinedNodes.insert(id);
+                move.examinedNodes.insert(networkA.nodes[id].netConnections.begin(), networkA.nodes[id].netConnections.end());
+                move.examinedRings.insert(networkA.nodes[id].dualConnections.begin(), networkA.nodes[id].dualConnections.end());
+            }
+        }
+        if (genSwitchOperations(move.baseNode1, move.baseNode2, move.ringNode1, move.ringNode2,
+                                move.bondBreaks, move.bondMakes,
+                                move.angleBreaks, move.angleMakes,
+                                move.ringBondBreakMake, move.involvedNodes, move.shellNodes)) {
+            move.templateCase = RelaxationTemplates::getCase(networkB.nodes[move.ringNode1].netConnections.size(),
+                                                             networkB.nodes[move.ringNode2].netConnections.size());
+            std::vector<int> orderedRingNodes = {move.ringBondBreakMake[1], move.ringBondBreakMake[3], move.ringBondBreakMake[0], move.ringBondBreakMake[2]};
+            std::tie(move.rotatedCoord1, move.rotatedCoord2) = rotateBond(move.baseNode1, move.baseNode2, getRingsDirection(orderedRingNodes));
+            return move;
+        }
+    }
+    logger->error("Cannot find any valid switch moves");
+    throw std::runtime_error("Cannot find any valid switch moves");
+}
+
+/**
+ * @brief Get the next switch move, using the move prepared on the helper thread if there is one
+ * @return The switch move
+ */
+SwitchMove LinkedNetwork::takeSwitchMove() {
+    if (!preparedSwitchMove.has_value()) {
+        return findSwitchMove();
+    }
+    SwitchMove move = std::move(*preparedSwitchMove);
+    preparedSwitchMove.reset();
+    if (move.epoch != acceptanceEpoch) {
+        // Coordinates have changed since the move was prepared, but the topology it was found from has not
+        std::vector<int> orderedRingNodes = {move.ringBondBreakMake[1], move.ringBondBreakMake[3], move.ringBondBreakMake[0], move.ringBondBreakMake[2]};
+        std::tie(move.rotatedCoord1, move.rotatedCoord2) = rotateBond(move.baseNode1, move.baseNode2, getRingsDirection(orderedRingNodes));
+        move.epoch = acceptanceEpoch;
+    }
+    return move;
+}
 
-        std::tie(baseNode1, baseNode2, ringNode1, ringNode2) = result;
-        logger->debug("Picked base nodes: {} {} and ring nodes: {} {}", baseNode1, baseNode2, ringNode1, ringNode2);
-        foundValidMove = genSwitchOperations(baseNode1, baseNode2, ringNode1, ringNode2,
-                                             bondBreaks, bondMakes,
-                                             angleBreaks, angleMakes,
-                                             ringBondBreakMake, involvedNodes);
-        if (foundValidMove)
-            break;
+/**
+ * @brief Start finding the next switch move on a helper thread from the committed state of the network.
+ * The BSS networks must not be modified until the move has been collected with collectNextSwitchMove.
+ */
+void LinkedNetwork::prepareNextSwitchMove() {
+    preparedRandomNumGen = randomNumGen;
+    nextSwitchMove = std::async(std::launch::async, &LinkedNetwork::findSwitchMove, this);
+}
+
+/**
+ * @brief Wait for the helper thread to finish preparing the next switch move
+ */
+void LinkedNetwork::collectNextSwitchMove() {
+    if (nextSwitchMove.valid()) {
+        preparedSwitchMove = nextSwitchMove.get();
+    }
+}
+
+/**
+ * @brief Discard the prepared switch move if an accepted move changed any part of the network it was found from.
+ * The random number generator is rewound so the move is found again from the same random numbers, which keeps
+ * the sequence of proposals identical to finding every move on the main thread.
+ * @param acceptedMove the move that has just been accepted
+ */
+void LinkedNetwork::validatePreparedSwitchMove(const SwitchMove &acceptedMove) {
+    if (!preparedSwitchMove.has_value()) {
+        return;
+    }
+    // Weights of non-uniform selection depend on the coordinates, which have all changed
+    bool isValid = selectionType == SelectionType::RANDOM;
+    for (const int &id : acceptedMove.bondBreaks) {
+        isValid = isValid && preparedSwitchMove->examinedNodes.count(id) == 0;
+    }
+    for (const int &id : acceptedMove.ringBondBreakMake) {
+        isValid = isValid && preparedSwitchMove->examinedRings.count(id) == 0;
     }
+    if (!isValid) {
+        logger->debug("Discarding prepared move, it overlaps the accepted move");
+        preparedSwitchMove.reset();
+        randomNumGen = preparedRandomNumGen;
+        numDiscardedProposals++;
+    }
+}
 
-    if (!foundValidMove) {
-        logger->error("Cannot find any valid switch moves");
-        throw std::runtime_error("Cannot find any valid switch moves");
+/**
+ * @brief Perform a monte carlo switch move, evaluate energy, and accept or reject
+ */
+void LinkedNetwork::monteCarloSwitchMoveLAMMPS(const double &temperature) {
+    if (temperature >= topologyOnlyTemperature) {
+        topologySwitchMove();
+        return;
     }
+    syncLammpsNetwork();
+    if (switchBatchSize > 1) {
+        monteCarloBatchSwitchMove(temperature);
+        return;
+    }
+    SwitchMove move = takeSwitchMove();
     numSwitches++;
     logger->debug("Switch number: {}", numSwitches);
+    int heatmapCell = getHeatmapCell(move);
 
     // Save current state
     double initialEnergy = energy;
+    double forwardProbability = selectionType == SelectionType::STRAIN ? getBondProposalProbability(move.baseNode1, move.baseNode2, weights) : 1.0;
+
+    // A proposal repeated since the last acceptance starts from the same state and, without the topology cache or
+    // relaxation templates, relaxes to the same geometry, so it is tested on its stored outcome with a fresh draw and
+    // only relaxed again to recover the coordinates if it is accepted
+    uint64_t proposalKey = getProposalKey(move.baseNode1, move.baseNode2, move.ringNode1, move.ringNode2);
+    bool isRepeated = false;
+    if (reuseProposalOutcomes) {
+        if (auto it = proposalOutcomes.find(proposalKey); it != proposalOutcomes.end()) {
+            numReusedProposals++;
+            const ProposalOutcome &outcome = it->second;
+            if (outcome.result == ProposalResult::FAILED_ANGLE_CHECK) {
+                logger->debug("Rejected repeated move: angles are not within range");
+                failedAngleChecks++;
+                heatmap.record(heatmapCell, SwitchOutcome::FAILED_ANGLE_CHECK);
+                return;
+            }
+            if (outcome.result == ProposalResult::FAILED_BOND_LENGTH_CHECK) {
+                logger->debug("Rejected repeated move: bond lengths are not within range");
+                failedBondLengthChecks++;
+                heatmap.record(heatmapCell, SwitchOutcome::FAILED_BOND_LENGTH_CHECK);
+                return;
+            }
+            if (!metropolisCondition.acceptanceCriterion(outcome.finalEnergy, initialEnergy, temperature, outcome.proposalRatio)) {
+                logger->debug("Rejected repeated move: failed Metropolis criterion: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialEnergy, outcome.finalEnergy);
+                failedEnergyChecks++;
+                heatmap.record(heatmapCell, SwitchOutcome::FAILED_ENERGY_CHECK);
+                return;
+            }
+            isRepeated = true;
+        }
+    }
 
-    std::vector<Node> initialInvolvedNodesA;
-    for (const auto &id : involvedNodes) {
-        initialInvolvedNodesA.push_back(networkA.nodes[id]);
+    for (const auto &id : move.involvedNodes) {
+        move.initialInvolvedNodesA.push_back(networkA.nodes[id]);
     }
-    std::vector<Node> initialInvolvedNodesB;
-    for (const auto &id : ringBondBreakMake) {
-        initialInvolvedNodesB.push_back(networkB.nodes[id]);
+    for (const auto &id : move.ringBondBreakMake) {
+        move.initialInvolvedNodesB.push_back(networkB.nodes[id]);
     }
 
-    // Switch and geometry optimise
-    logger->debug("Switching BSS Network...");
-    switchNetMCGraphene(bondBreaks, ringBondBreakMake);
-    std::vector<double> rotatedCoord1;
-    std::vector<double> rotatedCoord2;
-    std::vector<int> orderedRingNodes = {ringBondBreakMake[1], ringBondBreakMake[3], ringBondBreakMake[0], ringBondBreakMake[2]};
-    std::tie(rotatedCoord1, rotatedCoord2) = rotateBond(baseNode1, baseNode2, getRingsDirection(orderedRingNodes));
-
     logger->debug("Switching LAMMPS Network...");
+    lammpsNetwork.switchGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes, move.rotatedCoord1, move.rotatedCoord2);
 
-    lammpsNetwork.switchGraphene(bondBreaks, bondMakes, angleBreaks, angleMakes, rotatedCoord1, rotatedCoord2);
+    // The next move is found from the committed BSS networks while LAMMPS minimises
+    if (pipelineProposals) {
+        prepareNextSwitchMove();
+    }
 
     // Geometry optimisation of local region
     logger->debug("Minimising network...");
-    lammpsNetwork.minimiseNetwork();
-    std::vector<double> lammpsCoords = lammpsNetwork.getCoords(2);
+    bool isTemplateApplied = applyRelaxationTemplate(move);
+    int minimiserIterations;
+    auto relaxationStart = std::chrono::steady_clock::now();
+    double finalEnergy = relaxNetwork(topologyHash ^ getSwitchHashDelta(move.bondBreaks), relaxedCoords, minimiserIterations);
+    std::chrono::duration<double, std::milli> relaxationTime = std::chrono::steady_clock::now() - relaxationStart;
+    heatmap.recordRelaxation(heatmapCell, relaxationTime.count());
+    if (relaxationTemplates.isEnabled && minimiserIterations >= 0) {
+        relaxationTemplates.recordIterations(isTemplateApplied, minimiserIterations);
+        learnRelaxationTemplate(move, relaxedCoords);
+    }
+    collectNextSwitchMove();
+
+    logger->debug("Switching BSS Network...");
+    switchNetMCGraphene(move.bondBreaks, move.ringBondBreakMake);
 
     logger->debug("Accepting or rejecting...");
-    if (!checkAnglesWithinRange(setDifference(involvedNodes, fixedNodes), lammpsCoords)) {
+    if (!checkAnglesWithinRange(getUnfixedNodes(move.involvedNodes), relaxedCoords)) {
         logger->debug("Rejected move: angles are not within range");
         failedAngleChecks++;
-        rejectMove(initialInvolvedNodesA, initialInvolvedNodesB, bondBreaks, bondMakes, angleBreaks, angleMakes);
+        heatmap.record(heatmapCell, SwitchOutcome::FAILED_ANGLE_CHECK);
+        if (reuseProposalOutcomes) {
+            proposalOutcomes[proposalKey] = {ProposalResult::FAILED_ANGLE_CHECK, finalEnergy, 1.0};
+        }
+        rejectMove(move);
         return;
     }
-    if (!checkBondLengths(involvedNodes, lammpsCoords)) {
+    if (!checkBondLengths(move.involvedNodes, relaxedCoords)) {
         logger->debug("Rejected move: bond lengths are not within range");
         failedBondLengthChecks++;
-        rejectMove(initialInvolvedNodesA, initialInvolvedNodesB, bondBreaks, bondMakes, angleBreaks, angleMakes);
+        heatmap.record(heatmapCell, SwitchOutcome::FAILED_BOND_LENGTH_CHECK);
+        if (reuseProposalOutcomes) {
+            proposalOutcomes[proposalKey] = {ProposalResult::FAILED_BOND_LENGTH_CHECK, finalEnergy, 1.0};
+        }
+        rejectMove(move);
         return;
     }
-    double finalEnergy = lammpsNetwork.getPotentialEnergy();
-    if (!metropolisCondition.acceptanceCriterion(finalEnergy, initialEnergy, temperature)) {
+    // Strain weights of the trial network give the probability of proposing the reverse move
+    double proposalRatio = 1.0;
+    if (selectionType == SelectionType::STRAIN) {
+        lammpsNetwork.getAtomEnergies(relaxedAtomEnergies);
+        getStrainWeights(relaxedAtomEnergies, proposedWeights);
+        proposalRatio = getBondProposalProbability(move.baseNode1, move.baseNode2, proposedWeights) / forwardProbability;
+    }
+    if (reuseProposalOutcomes) {
+        proposalOutcomes[proposalKey] = {ProposalResult::RELAXED, finalEnergy, proposalRatio};
+    }
+    if (!isRepeated && !metropolisCondition.acceptanceCriterion(finalEnergy, initialEnergy, temperature, proposalRatio)) {
         logger->debug("Rejected move: failed Metropolis criterion: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialEnergy, finalEnergy);
         failedEnergyChecks++;
-        rejectMove(initialInvolvedNodesA, initialInvolvedNodesB, bondBreaks, bondMakes, angleBreaks, angleMakes);
+        heatmap.record(heatmapCell, SwitchOutcome::FAILED_ENERGY_CHECK);
+        rejectMove(move);
         return;
     }
     logger->debug("Accepted Move: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialEnergy, finalEnergy);
     numAcceptedSwitches++;
+    heatmap.record(heatmapCell, SwitchOutcome::ACCEPTED);
+    acceptanceEpoch++;
+    proposalOutcomes.clear();
     logger->debug("Syncing LAMMPS coordinates to BSS coordinates...");
-    currentCoords = lammpsCoords;
+    currentCoords.swap(relaxedCoords);
     pushCoords(currentCoords);
-    updateWeights();
-    arrangeNeighboursClockwise(involvedNodes, currentCoords);
+    if (selectionType == SelectionType::STRAIN) {
+        currentAtomEnergies.swap(relaxedAtomEnergies);
+        weights.swap(proposedWeights);
+        nodeDistribution.param(std::discrete_distribution<>::param_type(weights.begin(), weights.end()));
+    } else {
+        updateWeights();
+    }
+    arrangeNeighboursClockwise(move.involvedNodes, currentCoords);
     energy = finalEnergy;
+    validatePreparedSwitchMove(move);
     if (writeMovie)
-        lammpsNetwork.writeMovie();
+        writeMovieFrame();
+}
+
+/**
+ * @brief Perform up to switchBatchSize switch moves whose regions do not touch, relax them all in a single
+ * minimisation, and accept or reject each move on the change in the energy of its own region. Regions are at least
+ * three bonds apart, so no bond or angle has atoms in two of them. Rejected regions are restored to their
+ * coordinates before the batch and, unless every move was accepted or rejected, the network is minimised again.
+ * @param temperature the temperature of the Metropolis condition
+ */
+void LinkedNetwork::monteCarloBatchSwitchMove(const double &temperature) {
+    // Find moves from the unswitched network, skipping any that touch the region or rings of a move already found
+    std::vector<SwitchMove> moves;
+    std::vector<std::unordered_set<int>> regions;
+    std::unordered_set<int> claimedNodes;
+    std::unordered_set<int> claimedRings;
+    for (int attempt = 0; moves.size() < switchBatchSize && attempt < 10 * switchBatchSize; ++attempt) {
+        SwitchMove move = findSwitchMove();
+        std::unordered_set<int> region = getSwitchRegion(move);
+        bool isSeparated = std::none_of(region.begin(), region.end(), [&claimedNodes](const int &id) { return claimedNodes.count(id) > 0; }) &&
+                           std::none_of(move.ringBondBreakMake.begin(), move.ringBondBreakMake.end(), [&claimedRings](const int &id) { return claimedRings.count(id) > 0; });
+        if (!isSeparated) {
+            continue;
+        }
+        // Nodes within two bonds of the region are claimed too, so no angle has an end in each of two regions
+        for (const int &id : region) {
+            claimedNodes.insert(id);
+            for (const int &neighbourID : networkA.nodes[id].netConnections) {
+                claimedNodes.insert(neighbourID);
+                claimedNodes.insert(networkA.nodes[neighbourID].netConnections.begin(), networkA.nodes[neighbourID].netConnections.end());
+            }
+        }
+        claimedRings.insert(move.ringBondBreakMake.begin(), move.ringBondBreakMake.end());
+        moves.push_back(std::move(move));
+        regions.push_back(std::move(region));
+    }
+    logger->debug("Batch of {} switches", moves.size());
+
+    lammpsNetwork.getAtomEnergies(currentAtomEnergies);
+    std::vector<double> forwardProbabilities;
+    std::vector<int> heatmapCells;
+    for (SwitchMove &move : moves) {
+        numSwitches++;
+        heatmapCells.push_back(getHeatmapCell(move));
+        if (selectionType == SelectionType::STRAIN) {
+            forwardProbabilities.push_back(getBondProposalProbability(move.baseNode1, move.baseNode2, weights));
+        }
+        for (const auto &id : move.involvedNodes) {
+            move.initialInvolvedNodesA.push_back(networkA.nodes[id]);
+        }
+        for (const auto &id : move.ringBondBreakMake) {
+            move.initialInvolvedNodesB.push_back(networkB.nodes[id]);
+        }
+        lammpsNetwork.switchGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes, move.rotatedCoord1, move.rotatedCoord2);
+        switchNetMCGraphene(move.bondBreaks, move.ringBondBreakMake);
+    }
+
+    logger->debug("Minimising network...");
+    auto relaxationStart = std::chrono::steady_clock::now();
+    lammpsNetwork.minimiseNetwork();
+    std::chrono::duration<double, std::milli> relaxationTime = std::chrono::steady_clock::now() - relaxationStart;
+    // The single minimisation is shared equally between the moves of the batch
+    for (const int &cell : heatmapCells) {
+        heatmap.recordRelaxation(cell, relaxationTime.count() / moves.size());
+    }
+    lammpsNetwork.getCoords(relaxedCoords, 2);
+    lammpsNetwork.getAtomEnergies(relaxedAtomEnergies);
+    numBatchRelaxations++;
+    if (selectionType == SelectionType::STRAIN) {
+        getStrainWeights(relaxedAtomEnergies, proposedWeights);
+    }
+
+    logger->debug("Accepting or rejecting...");
+    std::vector<bool> isAccepted(moves.size(), false);
+    int numAccepted = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const SwitchMove &move = moves[i];
+        if (!checkAnglesWithinRange(getUnfixedNodes(move.involvedNodes), relaxedCoords)) {
+            logger->debug("Rejected move: angles are not within range");
+            failedAngleChecks++;
+            heatmap.record(heatmapCells[i], SwitchOutcome::FAILED_ANGLE_CHECK);
+            continue;
+        }
+        if (!checkBondLengths(move.involvedNodes, relaxedCoords)) {
+            logger->debug("Rejected move: bond lengths are not within range");
+            failedBondLengthChecks++;
+            heatmap.record(heatmapCells[i], SwitchOutcome::FAILED_BOND_LENGTH_CHECK);
+            continue;
+        }
+        double initialRegionEnergy = 0.0;
+        double finalRegionEnergy = 0.0;
+        for (const int &id : regions[i]) {
+            initialRegionEnergy += currentAtomEnergies[id];
+            finalRegionEnergy += relaxedAtomEnergies[id];
+        }
+        double proposalRatio = 1.0;
+        if (selectionType == SelectionType::STRAIN) {
+            proposalRatio = getBondProposalProbability(move.baseNode1, move.baseNode2, proposedWeights) / forwardProbabilities[i];
+        }
+        if (!metropolisCondition.acceptanceCriterion(finalRegionEnergy, initialRegionEnergy, temperature, proposalRatio)) {
+            logger->debug("Rejected move: failed Metropolis criterion: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialRegionEnergy, finalRegionEnergy);
+            failedEnergyChecks++;
+            heatmap.record(heatmapCells[i], SwitchOutcome::FAILED_ENERGY_CHECK);
+            continue;
+        }
+        logger->debug("Accepted Move: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialRegionEnergy, finalRegionEnergy);
+        heatmap.record(heatmapCells[i], SwitchOutcome::ACCEPTED);
+        isAccepted[i] = true;
+        numAccepted++;
+    }
+
+    // Rejected regions are restored in the relaxed network, everything else keeps its relaxed coordinates
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (isAccepted[i]) {
+            continue;
+        }
+        revertNetMCGraphene(moves[i].bondBreaks, moves[i].initialInvolvedNodesA, moves[i].initialInvolvedNodesB);
+        topologyHash ^= getSwitchHashDelta(moves[i].bondBreaks);
+        lammpsNetwork.revertGraphene(moves[i].bondBreaks, moves[i].bondMakes, moves[i].angleBreaks, moves[i].angleMakes);
+        for (const int &id : regions[i]) {
+            relaxedCoords[id * 2] = currentCoords[id * 2];
+            relaxedCoords[id * 2 + 1] = currentCoords[id * 2 + 1];
+        }
+    }
+    logger->debug("Syncing LAMMPS coordinates to BSS coordinates...");
+    if (numAccepted == 0) {
+        // Nothing has changed, so the whole network can be restored exactly
+        lammpsNetwork.setCoords(currentCoords, 2);
+        return;
+    }
+    numAcceptedSwitches += numAccepted;
+    acceptanceEpoch += numAccepted;
+    proposalOutcomes.clear();
+    currentCoords.swap(relaxedCoords);
+    if (numAccepted < moves.size()) {
+        // Atoms around a restored region relaxed under the rejected topology, so the spliced network is minimised again
+        lammpsNetwork.setCoords(currentCoords, 2);
+        lammpsNetwork.minimiseNetwork();
+        lammpsNetwork.getCoords(currentCoords, 2);
+    }
+    energy = lammpsNetwork.getPotentialEnergy();
+    pushCoords(currentCoords);
+    if (selectionType == SelectionType::STRAIN) {
+        // Keep the weights the reverse moves were proposed with, rather than reading every atom energy again, so the
+        // next batch draws its moves from the same distribution as the Hastings ratios of this one assumed
+        weights.swap(proposedWeights);
+        nodeDistribution.param(std::discrete_distribution<>::param_type(weights.begin(), weights.end()));
+    } else {
+        updateWeights();
+    }
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (isAccepted[i]) {
+            arrangeNeighboursClockwise(moves[i].involvedNodes, currentCoords);
+        }
+    }
+    if (writeMovie)
+        writeMovieFrame();
+}
+
+/**
+ * @brief Get the number of rings with six nodes
+ * @return The number of hexagons in the ring network
+ */
+int LinkedNetwork::countHexagons() const {
+    return static_cast<int>(std::count_if(networkB.nodes.begin(), networkB.nodes.end(),
+                                          [](const Node &node) { return node.netConnections.size() == 6; }));
+}
+
+/**
+ * @brief Get the fraction of rings of every allowed size
+ * @return Fraction of rings of each size from minRingSize to maxRingSize
+ */
+std::vector<double> LinkedNetwork::getRingSizeFractions() const {
+    std::vector<double> fractions(maxRingSize - minRingSize + 1, 0.0);
+    for (const Node &node : networkB.nodes) {
+        int ringSize = static_cast<int>(node.netConnections.size());
+        if (ringSize >= minRingSize && ringSize <= maxRingSize) {
+            fractions[ringSize - minRingSize] += 1.0;
+        }
+    }
+    vectorDivide(fractions, static_cast<double>(networkB.nodes.size()));
+    return fractions;
+}
+
+/**
+ * @brief Perform a switch move accepted by the Wang-Landau criterion rather than the Metropolis criterion, then
+ * record a visit to the bin of the resulting network. The topology cache, relaxation templates and movie are used
+ * as in monteCarloSwitchMoveLAMMPS, but moves are never batched, pipelined or made to the BSS networks only.
+ * @param wangLandau The density of states shared by every walker
+ * @param temperature The temperature of the Boltzmann factor when sampling the fraction of hexagons
+ */
+void LinkedNetwork::wangLandauSwitchMove(WangLandau &wangLandau, const double &temperature) {
+    if (numHexagons < 0) {
+        numHexagons = countHexagons();
+    }
+    SwitchMove move = findSwitchMove();
+    numSwitches++;
+    logger->debug("Switch number: {}", numSwitches);
+    int heatmapCell = getHeatmapCell(move);
+
+    double initialEnergy = energy;
+    double initialValue = wangLandau.getOrderParameter(energy, numHexagons, static_cast<int>(networkB.nodes.size()));
+    for (const auto &id : move.involvedNodes) {
+        move.initialInvolvedNodesA.push_back(networkA.nodes[id]);
+    }
+    // Only the four rings of the move change size
+    int hexagonChange = 0;
+    for (const auto &id : move.ringBondBreakMake) {
+        move.initialInvolvedNodesB.push_back(networkB.nodes[id]);
+        hexagonChange -= networkB.nodes[id].netConnections.size() == 6;
+    }
+
+    lammpsNetwork.switchGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes, move.rotatedCoord1, move.rotatedCoord2);
+    bool isTemplateApplied = applyRelaxationTemplate(move);
+    int minimiserIterations;
+    auto relaxationStart = std::chrono::steady_clock::now();
+    double finalEnergy = relaxNetwork(topologyHash ^ getSwitchHashDelta(move.bondBreaks), relaxedCoords, minimiserIterations);
+    std::chrono::duration<double, std::milli> relaxationTime = std::chrono::steady_clock::now() - relaxationStart;
+    heatmap.recordRelaxation(heatmapCell, relaxationTime.count());
+    if (relaxationTemplates.isEnabled && minimiserIterations >= 0) {
+        relaxationTemplates.recordIterations(isTemplateApplied, minimiserIterations);
+        learnRelaxationTemplate(move, relaxedCoords);
+    }
+    switchNetMCGraphene(move.bondBreaks, move.ringBondBreakMake);
+    for (const auto &id : move.ringBondBreakMake) {
+        hexagonChange += networkB.nodes[id].netConnections.size() == 6;
+    }
+    double finalValue = wangLandau.getOrderParameter(finalEnergy, numHexagons + hexagonChange, static_cast<int>(networkB.nodes.size()));
+
+    if (!checkAnglesWithinRange(getUnfixedNodes(move.involvedNodes), relaxedCoords)) {
+        logger->debug("Rejected move: angles are not within range");
+        failedAngleChecks++;
+        heatmap.record(heatmapCell, SwitchOutcome::FAILED_ANGLE_CHECK);
+        rejectMove(move);
+    } else if (!checkBondLengths(move.involvedNodes, relaxedCoords)) {
+        logger->debug("Rejected move: bond lengths are not within range");
+        failedBondLengthChecks++;
+        heatmap.record(heatmapCell, SwitchOutcome::FAILED_BOND_LENGTH_CHECK);
+        rejectMove(move);
+    } else if (!wangLandau.acceptanceCriterion(initialValue, finalValue, finalEnergy - initialEnergy, temperature,
+                                               std::uniform_real_distribution<double>(0.0, 1.0)(randomNumGen))) {
+        logger->debug("Rejected move: failed Wang-Landau criterion: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialEnergy, finalEnergy);
+        failedEnergyChecks++;
+        heatmap.record(heatmapCell, SwitchOutcome::FAILED_ENERGY_CHECK);
+        rejectMove(move);
+    } else {
+        logger->debug("Accepted Move: Ei = {:.3f} Eh, Ef = {:.3f} Eh", initialEnergy, finalEnergy);
+        numAcceptedSwitches++;
+        heatmap.record(heatmapCell, SwitchOutcome::ACCEPTED);
+        acceptanceEpoch++;
+        proposalOutcomes.clear();
+        currentCoords.swap(relaxedCoords);
+        pushCoords(currentCoords);
+        updateWeights();
+        arrangeNeighboursClockwise(move.involvedNodes, currentCoords);
+        energy = finalEnergy;
+        numHexagons += hexagonChange;
+        initialValue = finalValue;
+        if (writeMovie)
+            writeMovieFrame();
+    }
+    wangLandau.visit(initialValue, getRingSizeFractions());
+}
+
+/**
+ * @brief Replace the LAMMPS instance of this network with its replica in an instance holding several networks,
+ * closing its own instance
+ * @param replicaObject The object for this network's replica, from LammpsObject::getReplica
+ */
+void LinkedNetwork::usePackedLammps(const LammpsObject &replicaObject) {
+    bool isVerifyingEdits = lammpsNetwork.isVerifyingEdits;
+    lammpsNetwork.close();
+    lammpsNetwork = replicaObject;
+    lammpsNetwork.isVerifyingEdits = isVerifyingEdits;
+    lammpsNetwork.setCoords(currentCoords, 2);
 }
 
-void LinkedNetwork::rejectMove(const std::vector<Node> &initialInvolvedNodesA, const std::vector<Node> &initialInvolvedNodesB,
-                               const std::vector<int> &bondBreaks, const std::vector<int> &bondMakes,
-                               const std::vector<int> &angleBreaks, const std::vector<int> &angleMakes) {
+/**
+ * @brief Find a switch move and make it in the BSS networks and this network's replica in a packed LAMMPS instance,
+ * to be relaxed in one minimisation with a move of every other replica and then finished by finishPackedSwitchMove
+ * @return The switch move made
+ */
+SwitchMove LinkedNetwork::startPackedSwitchMove() {
+    SwitchMove move = findSwitchMove();
+    numSwitches++;
+    logger->debug("Switch number: {}", numSwitches);
+    for (const auto &id : move.involvedNodes) {
+        move.initialInvolvedNodesA.push_back(networkA.nodes[id]);
+    }
+    for (const auto &id : move.ringBondBreakMake) {
+        move.initialInvolvedNodesB.push_back(networkB.nodes[id]);
+    }
+    lammpsNetwork.switchGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes, move.rotatedCoord1, move.rotatedCoord2);
+    switchNetMCGraphene(move.bondBreaks, move.ringBondBreakMake);
+    return move;
+}
+
+/**
+ * @brief Accept or reject a move made by startPackedSwitchMove once the packed instance has been minimised.
+ * relaxedCoords must already hold this replica's relaxed coordinates. Rejections restore only this replica, which
+ * leaves the others relaxed as they share no bonds or angles with it.
+ * @param move The switch move made
+ * @param finalEnergy The relaxed energy of this replica
+ * @param temperature The temperature of the Metropolis condition
+ */
+void LinkedNetwork::finishPackedSwitchMove(const SwitchMove &move, const double &finalEnergy, const double &temperature) {
+    if (!checkAnglesWithinRange(getUnfixedNodes(move.involvedNodes), relaxedCoords)) {
+        logger->debug("Rejected move: angles are not within range");
+        failedAngleChecks++;
+        rejectMove(move);
+        return;
+    }
+    if (!checkBondLengths(move.involvedNodes, relaxedCoords)) {
+        logger->debug("Rejected move: bond lengths are not within range");
+        failedBondLengthChecks++;
+        rejectMove(move);
+        return;
+    }
+    if (!metropolisCondition.acceptanceCriterion(finalEnergy, energy, temperature)) {
+        logger->debug("Rejected move: failed Metropolis criterion: Ei = {:.3f} Eh, Ef = {:.3f} Eh", energy, finalEnergy);
+        failedEnergyChecks++;
+        rejectMove(move);
+        return;
+    }
+    logger->debug("Accepted Move: Ei = {:.3f} Eh, Ef = {:.3f} Eh", energy, finalEnergy);
+    numAcceptedSwitches++;
+    acceptanceEpoch++;
+    proposalOutcomes.clear();
+    currentCoords.swap(relaxedCoords);
+    pushCoords(currentCoords);
+    updateWeights();
+    arrangeNeighboursClockwise(move.involvedNodes, currentCoords);
+    energy = finalEnergy;
+}
+
+/**
+ * @brief Get the base nodes that belong to a switch move when it is relaxed alongside other moves, which are its
+ * first and second neighbour shells and every node within batchRegionRadius bonds of them
+ * @param move the switch move
+ * @return IDs of the base nodes in the region of the move
+ */
+std::unordered_set<int> LinkedNetwork::getSwitchRegion(const SwitchMove &move) const {
+    std::unordered_set<int> region(move.shellNodes.begin(), move.shellNodes.end());
+    std::vector<int> frontier = move.shellNodes;
+    std::vector<int> nextFrontier;
+    for (int bond = 0; bond < batchRegionRadius; ++bond) {
+        nextFrontier.clear();
+        for (const int &id : frontier) {
+            for (const int &neighbourID : networkA.nodes[id].netConnections) {
+                if (region.insert(neighbourID).second) {
+                    nextFrontier.push_back(neighbourID);
+                }
+            }
+        }
+        frontier.swap(nextFrontier);
+    }
+    return region;
+}
+
+/**
+ * @brief Perform a switch move on the BSS networks only. The temperature is treated as infinite, so every move that
+ * passes the angle and bond length checks is accepted. Instead of minimising, the first shell of the switched bond is
+ * embedded between its neighbours, and LAMMPS is resynchronised every topologyOnlyRelaxInterval accepted moves or
+ * before the next move that needs it.
+ */
+void LinkedNetwork::topologySwitchMove() {
+    SwitchMove move = takeSwitchMove();
+    numSwitches++;
+    numTopologyOnlySwitches++;
+    logger->debug("Topology-only switch number: {}", numSwitches);
+    int heatmapCell = getHeatmapCell(move);
+
+    for (const auto &id : move.involvedNodes) {
+        move.initialInvolvedNodesA.push_back(networkA.nodes[id]);
+    }
+    for (const auto &id : move.ringBondBreakMake) {
+        move.initialInvolvedNodesB.push_back(networkB.nodes[id]);
+    }
+    std::vector<double> initialShellCoords;
+    initialShellCoords.reserve(2 * move.shellNodes.size());
+    for (const int &id : move.shellNodes) {
+        initialShellCoords.push_back(currentCoords[id * 2]);
+        initialShellCoords.push_back(currentCoords[id * 2 + 1]);
+    }
+
+    switchNetMCGraphene(move.bondBreaks, move.ringBondBreakMake);
+    embedSwitch(move);
+
+    bool isAnglesValid = checkAnglesWithinRange(getUnfixedNodes(move.involvedNodes), currentCoords);
+    bool isBondLengthsValid = isAnglesValid && checkBondLengths(move.involvedNodes, currentCoords);
+    if (!isAnglesValid || !isBondLengthsValid) {
+        if (isAnglesValid) {
+            logger->debug("Rejected topology-only move: bond lengths are not within range");
+            failedBondLengthChecks++;
+            heatmap.record(heatmapCell, SwitchOutcome::FAILED_BOND_LENGTH_CHECK);
+        } else {
+            logger->debug("Rejected topology-only move: angles are not within range");
+            failedAngleChecks++;
+            heatmap.record(heatmapCell, SwitchOutcome::FAILED_ANGLE_CHECK);
+        }
+        revertNetMCGraphene(move.bondBreaks, move.initialInvolvedNodesA, move.initialInvolvedNodesB);
+        topologyHash ^= getSwitchHashDelta(move.bondBreaks);
+        for (size_t i = 0; i < move.shellNodes.size(); ++i) {
+            currentCoords[move.shellNodes[i] * 2] = initialShellCoords[i * 2];
+            currentCoords[move.shellNodes[i] * 2 + 1] = initialShellCoords[i * 2 + 1];
+        }
+        return;
+    }
+    numAcceptedSwitches++;
+    heatmap.record(heatmapCell, SwitchOutcome::ACCEPTED);
+    acceptanceEpoch++;
+    proposalOutcomes.clear();
+    isLammpsOutOfSync = true;
+    for (const int &id : move.involvedNodes) {
+        networkA.nodes[id].crd = {currentCoords[id * 2], currentCoords[id * 2 + 1]};
+    }
+    for (const int &id : move.ringBondBreakMake) {
+        networkB.centreRing(id, networkA);
+    }
+    arrangeNeighboursClockwise(move.involvedNodes, currentCoords);
+    if (topologyOnlyRelaxInterval > 0 && ++numSwitchesSinceLammpsSync >= topologyOnlyRelaxInterval) {
+        syncLammpsNetwork();
+    }
+}
+
+/**
+ * @brief Place the switched bond at its rotated position, then move each node in the first shell to the centroid of
+ * its neighbours while the second shell stays fixed. The rings around the bond end up convex without minimising.
+ * @param move the switch move, which has already been applied to the BSS networks
+ */
+void LinkedNetwork::embedSwitch(const SwitchMove &move) {
+    const int numSweeps = 10;
+    const int numFirstShellNodes = 6;
+    currentCoords[move.baseNode1 * 2] = move.rotatedCoord1[0];
+    currentCoords[move.baseNode1 * 2 + 1] = move.rotatedCoord1[1];
+    currentCoords[move.baseNode2 * 2] = move.rotatedCoord2[0];
+    currentCoords[move.baseNode2 * 2 + 1] = move.rotatedCoord2[1];
+    for (int sweep = 0; sweep < numSweeps; ++sweep) {
+        for (int i = 0; i < numFirstShellNodes; ++i) {
+            int nodeID = move.shellNodes[i];
+            if (isFixedNode[nodeID]) {
+                continue;
+            }
+            std::vector<double> coord = {currentCoords[nodeID * 2], currentCoords[nodeID * 2 + 1]};
+            std::vector<double> offset(2, 0.0);
+            const std::vector<int> &neighbours = networkA.nodes[nodeID].netConnections;
+            for (const int &neighbourID : neighbours) {
+                std::vector<double> bondVector = pbcVector(coord, {currentCoords[neighbourID * 2], currentCoords[neighbourID * 2 + 1]}, dimensions);
+                offset[0] += bondVector[0];
+                offset[1] += bondVector[1];
+            }
+            coord[0] += offset[0] / neighbours.size();
+            coord[1] += offset[1] / neighbours.size();
+            wrapCoords(coord);
+            currentCoords[nodeID * 2] = coord[0];
+            currentCoords[nodeID * 2 + 1] = coord[1];
+        }
+    }
+}
+
+/**
+ * @brief Rebuild the LAMMPS topology from the BSS base network and minimise it, if topology-only switches have been
+ * made since LAMMPS was last synchronised
+ */
+void LinkedNetwork::syncLammpsNetwork() {
+    if (!isLammpsOutOfSync) {
+        return;
+    }
+    logger->debug("Resynchronising LAMMPS after {} topology-only switches", numSwitchesSinceLammpsSync);
+    std::vector<int> bonds;
+    std::vector<int> angles;
+    networkA.getBondsAndAngles(bonds, angles);
+    lammpsNetwork.setCoords(currentCoords, 2);
+    lammpsNetwork.rebuildTopology(bonds, angles);
+    lammpsNetwork.minimiseNetwork();
+    lammpsNetwork.getCoords(currentCoords, 2);
+    energy = lammpsNetwork.getPotentialEnergy();
+    pushCoords(currentCoords);
+    for (int nodeID = 0; nodeID < networkA.nodes.size(); ++nodeID) {
+        arrangeNeighboursClockwise(nodeID, currentCoords);
+    }
+    updateWeights();
+    topologyCache.insert(topologyHash, energy, currentCoords);
+    isLammpsOutOfSync = false;
+    numSwitchesSinceLammpsSync = 0;
+}
+
+/**
+ * @brief Compare every bond and angle in LAMMPS with the BSS base network, which replaces verifying every edit.
+ * Nothing is compared while topology-only switches are waiting to be synchronised.
+ * @throw std::runtime_error if LAMMPS and the base network differ
+ */
+void LinkedNetwork::auditLammpsTopology() {
+    if (isLammpsOutOfSync) {
+        return;
+    }
+    std::vector<int> networkBonds;
+    std::vector<int> networkAngles;
+    networkA.getBondsAndAngles(networkBonds, networkAngles);
+    std::vector<int> lammpsBonds = lammpsNetwork.getBonds();
+    std::vector<int> lammpsAngles = lammpsNetwork.getAngles();
+
+    // Put every bond and angle in a canonical order with one-indexed IDs
+    std::vector<std::array<int, 3>> expected;
+    std::vector<std::array<int, 3>> found;
+    // Bonds and angles whose atoms are all frozen are not held by LAMMPS
+    for (size_t i = 0; i < networkBonds.size(); i += 2) {
+        if (lammpsNetwork.isFrozen({networkBonds[i], networkBonds[i + 1]})) {
+            continue;
+        }
+        expected.push_back({std::min(networkBonds[i], networkBonds[i + 1]) + 1, std::max(networkBonds[i], networkBonds[i + 1]) + 1, 0});
+    }
+    for (size_t i = 0; i < networkAngles.size(); i += 3) {
+        if (lammpsNetwork.isFrozen({networkAngles[i], networkAngles[i + 1], networkAngles[i + 2]})) {
+            continue;
+        }
+        expected.push_back({std::min(networkAngles[i], networkAngles[i + 2]) + 1, networkAngles[i + 1] + 1, std::max(networkAngles[i], networkAngles[i + 2]) + 1});
+    }
+    for (size_t i = 0; i < lammpsBonds.size(); i += 2) {
+        found.push_back({std::min(lammpsBonds[i], lammpsBonds[i + 1]), std::max(lammpsBonds[i], lammpsBonds[i + 1]), 0});
+    }
+    for (size_t i = 0; i < lammpsAngles.size(); i += 3) {
+        found.push_back({std::min(lammpsAngles[i], lammpsAngles[i + 2]), lammpsAngles[i + 1], std::max(lammpsAngles[i], lammpsAngles[i + 2])});
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    std::vector<std::array<int, 3>> missing;
+    std::vector<std::array<int, 3>> extra;
+    std::set_difference(expected.begin(), expected.end(), found.begin(), found.end(), std::back_inserter(missing));
+    std::set_difference(found.begin(), found.end(), expected.begin(), expected.end(), std::back_inserter(extra));
+    if (missing.empty() && extra.empty()) {
+        logger->debug("LAMMPS topology audit at step {} found {} bonds and {} angles matching the network", numSwitches,
+                      lammpsBonds.size() / 2, lammpsAngles.size() / 3);
+        lastCleanAuditStep = numSwitches;
+        return;
+    }
+    // Bonds are stored with a third ID of 0
+    auto describe = [](const std::array<int, 3> &entry) {
+        return entry[2] == 0 ? fmt::format("bond {}-{}", entry[0], entry[1]) : fmt::format("angle {}-{}-{}", entry[0], entry[1], entry[2]);
+    };
+    const size_t maxLogged = 10;
+    for (size_t i = 0; i < missing.size() && i < maxLogged; ++i) {
+        logger->error("LAMMPS is missing {} of the network", describe(missing[i]));
+    }
+    for (size_t i = 0; i < extra.size() && i < maxLogged; ++i) {
+        logger->error("LAMMPS has {} that is not in the network", describe(extra[i]));
+    }
+    std::ostringstream oss;
+    oss << "LAMMPS topology differs from the network at step " << numSwitches << " with " << missing.size() << " missing and "
+        << extra.size() << " extra bonds and angles, the last clean audit was at step " << lastCleanAuditStep;
+    throw std::runtime_error(oss.str());
+}
+
+/**
+ * @brief Revert a switch move in both the BSS and LAMMPS networks
+ * @param move the switch move to revert
+ */
+void LinkedNetwork::rejectMove(const SwitchMove &move) {
     logger->debug("Reverting BSS Network...");
-    revertNetMCGraphene(initialInvolvedNodesA, initialInvolvedNodesB);
+    revertNetMCGraphene(move.bondBreaks, move.initialInvolvedNodesA, move.initialInvolvedNodesB);
+    topologyHash ^= getSwitchHashDelta(move.bondBreaks);
     logger->debug("Reverting LAMMPS Network...");
-    lammpsNetwork.revertGraphene(bondBreaks, bondMakes, angleBreaks, angleMakes);
+    lammpsNetwork.revertGraphene(move.bondBreaks, move.bondMakes, move.angleBreaks, move.angleMakes);
     logger->debug("Syncing LAMMPS coordinates to BSS coordinates...");
     lammpsNetwork.setCoords(currentCoords, 2);
 }
@@ -211,6 +1250,7 @@ void LinkedNetwork::showCoords(const std::vector<double> &coords) const {
  */
 void LinkedNetwork::rescale(double scaleFactor) {
     vectorMultiply(dimensions, scaleFactor);
+    heatmap.dimensions = dimensions;
     networkA.rescale(scaleFactor);
     networkB.rescale(scaleFactor);
 }
@@ -220,7 +1260,7 @@ void LinkedNetwork::updateWeights() {
         double boxLength = dimensions[0];
         for (int i = 0; i < networkA.nodes.size(); ++i) {
             double distance = networkA.nodes[i].distanceFrom(centreCoords) / boxLength;
-            weights[i] = std::exp(-distance * weightedDecay);
+            weights[i] = isNodeActive(i) ? std::exp(-distance * weightedDecay) : 0.0;
         }
 
         // Normalize weights
@@ -228,9 +1268,69 @@ void LinkedNetwork::updateWeights() {
         for (double &weight : weights) {
             weight /= total;
         }
-    } else { // SelectionType::RANDOM
+    } else if (selectionType == SelectionType::STRAIN) {
+        lammpsNetwork.getAtomEnergies(currentAtomEnergies);
+        getStrainWeights(currentAtomEnergies, weights);
+    } else if (weights.empty()) { // SelectionType::RANDOM in lean memory mode, nodes are drawn uniformly
+        return;
+    } else if (isActiveNode.empty()) { // SelectionType::RANDOM
         std::fill(weights.begin(), weights.end(), 1.0);
+    } else { // SelectionType::RANDOM within the active region
+        weights.assign(isActiveNode.begin(), isActiveNode.end());
     }
+    nodeDistribution.param(std::discrete_distribution<>::param_type(weights.begin(), weights.end()));
+}
+
+/**
+ * @brief Weight each node by its potential energy relative to the rest of the network, so the most strained node
+ * is e^weightedDecay times as likely to be picked as the least strained
+ * @param atomEnergies Potential energy of each node from a relaxed network
+ * @param nodeWeights Vector to hold the normalised weight of each node
+ */
+void LinkedNetwork::getStrainWeights(const std::vector<double> &atomEnergies, std::vector<double> &nodeWeights) const {
+    auto [minEnergy, maxEnergy] = std::minmax_element(atomEnergies.begin(), atomEnergies.end());
+    double energyRange = *maxEnergy - *minEnergy;
+    nodeWeights.resize(atomEnergies.size());
+    for (size_t i = 0; i < atomEnergies.size(); ++i) {
+        if (!isNodeActive(i)) {
+            nodeWeights[i] = 0.0;
+        } else {
+            nodeWeights[i] = energyRange > 0 ? std::exp(weightedDecay * (atomEnergies[i] - *maxEnergy) / energyRange) : 1.0;
+        }
+    }
+    double total = std::accumulate(nodeWeights.begin(), nodeWeights.end(), 0.0);
+    for (double &weight : nodeWeights) {
+        weight /= total;
+    }
+}
+
+/**
+ * @brief Get the probability that pickRandomConnection picks a bond from either of its ends. Switching a bond keeps
+ * the coordination of both its nodes, so the reverse move proposes the same bond in the switched network.
+ * @param baseNode1 ID of the first node in the bond
+ * @param baseNode2 ID of the second node in the bond
+ * @param nodeWeights Normalised selection weight of each node
+ * @return The probability of proposing the bond
+ */
+double LinkedNetwork::getBondProposalProbability(const int &baseNode1, const int &baseNode2, const std::vector<double> &nodeWeights) const {
+    return nodeWeights[baseNode1] / networkA.nodes[baseNode1].netConnections.size() +
+           nodeWeights[baseNode2] / networkA.nodes[baseNode2].netConnections.size();
+}
+
+/**
+ * @brief Draw a node to start a switch move from, using the selection weights if there are any
+ * @return ID of the chosen node in the base network
+ */
+int LinkedNetwork::pickRandomNode() {
+    if (weights.empty() && !activeNodes.empty()) {
+        std::uniform_int_distribution<int> randomActiveNode(0, static_cast<int>(activeNodes.size()) - 1);
+        return activeNodes[randomActiveNode(randomNumGen)];
+    }
+    if (weights.empty()) {
+        std::uniform_int_distribution<int> randomNode(0, static_cast<int>(networkA.nodes.size()) - 1);
+        return randomNode(randomNumGen);
+    }
+    return nodeDistribution(randomNumGen);
 }
 
 /**
@@ -239,9 +1339,6 @@ void LinkedNetwork::updateWeights() {
  * @throw std::runtime_error if the nodes in the random connection have coordinations other than 3 or 4.
  */
 std::tuple<int, int, int, int> LinkedNetwork::pickRandomConnection() {
-
-    // Create a discrete distribution based on the weights
-    std::discrete_distribution<> distribution(weights.begin(), weights.end());
     int randNode;
     int randNodeConnection;
     int sharedRingNode1;
@@ -251,7 +1348,7 @@ std::tuple<int, int, int, int> LinkedNetwork::pickRandomConnection() {
     std::uniform_int_distribution randomDirection(0, 1);
 
     while (pickingAcceptableRing) {
-        randNode = distribution(randomNumGen);
+        randNode = pickRandomNode();
         int randNodeCoordination = networkA.nodes[randNode].netConnections.size();
         randomCnx.param(std::uniform_int_distribution<int>::param_type(0, randNodeCoordination - 1));
         randNodeConnection = networkA.nodes[randNode].netConnections[randomCnx(randomNumGen)];
@@ -286,12 +1383,15 @@ std::tuple<int, int, int, int> LinkedNetwork::pickRandomConnection() {
  * @param angleBreaks the angles to break
  * @param angleMakes the angles to make
  * @param ringBondBreakMake the ring bond to break and make, first two indexes are bond to break, second two are bond to make
+ * @param convexCheckIDs the base nodes whose angles are checked after the switch
+ * @param shellNodes the first and second neighbour shells of the bond, baseNode1 to baseNode14 in order
  * @return true if the switch move is possible, false otherwise
  */
 bool LinkedNetwork::genSwitchOperations(int baseNode1, int baseNode2, int ringNode1, int ringNode2,
                                         std::vector<int> &bondBreaks, std::vector<int> &bondMakes,
                                         std::vector<int> &angleBreaks, std::vector<int> &angleMakes,
-                                        std::vector<int> &ringBondBreakMake, std::unordered_set<int> &convexCheckIDs) {
+                                        std::vector<int> &ringBondBreakMake, std::unordered_set<int> &convexCheckIDs,
+                                std::vector<int> &shellNodes) {
     // lots of error checking to remove any potential pathological cases
     if (baseNode1 == baseNode2 || ringNode1 == ringNode2) {
         logger->warn("Switch move not possible as baseNode1 = baseNode2 or ringNode1 = ringNode2: {} {} {} {}",
@@ -344,42 +1444,48 @@ bool LinkedNetwork::genSwitchOperations(int baseNode1, int baseNode2, int ringNo
         logger->debug("No valid move: Selected nodes describe an edge of two edge sharing triangles");
         return false;
     }
+    // Switches may only move nodes in the active region, which the switched bond and its first shell must be in
+    if (!isActiveNode.empty() && !(isActiveNode[baseNode1] && isActiveNode[baseNode2] && isActiveNode[baseNode3] &&
+                                   isActiveNode[baseNode4] && isActiveNode[baseNode5] && isActiveNode[baseNode6])) {
+        logger->debug("No valid move: Switch would move a node outside the active region");
+        return false;
+    }
     // Prevent rings having only two or fewer neighbours
     if (networkB.nodes[ringNode1].netConnections.size() <= 3 || networkB.nodes[ringNode2].netConnections.size() <= 3) {
         logger->debug("No valid move: Switch would result in a ring size less than 3");
         return false;
     }
 
-    // If the ringNodes are a member of fixedRings, the move will be allowed if the resulting ring size
+    // If the ringNodes are fixed rings, the move will be allowed if the resulting ring size
     // is within +/- 1 of the original ring size. This is to allow 3/4 membered rings adjacent to the fixedRing
     // to be able to escape being so. This would otherwise be impossible to remove 3/4 membered rings adjacent to a fixedRing.
-    if (fixedRings.count(ringNode1) > 0) {
+    if (fixedRingSizes[ringNode1] > 0) {
         int currentSize = networkB.nodes[ringNode1].netConnections.size();
-        if (currentSize == fixedRings[ringNode1] - 1) {
+        if (currentSize == fixedRingSizes[ringNode1] - 1) {
             logger->debug("No valid move: Switch would violate fixed ring size");
             return false;
         }
     }
 
-    if (fixedRings.count(ringNode2) > 0) {
+    if (fixedRingSizes[ringNode2] > 0) {
         int currentSize = networkB.nodes[ringNode2].netConnections.size();
-        if (currentSize == fixedRings[ringNode2] - 1) {
+        if (currentSize == fixedRingSizes[ringNode2] - 1) {
             logger->debug("No valid move: Switch would violate fixed ring size");
             return false;
         }
     }
 
-    if (fixedRings.count(ringNode3) > 0) {
+    if (fixedRingSizes[ringNode3] > 0) {
         int currentSize = networkB.nodes[ringNode3].netConnections.size();
-        if (currentSize == fixedRings[ringNode3] + 1) {
+        if (currentSize == fixedRingSizes[ringNode3] + 1) {
             logger->debug("No valid move: Switch would violate fixed ring size");
             return false;
         }
     }
 
-    if (fixedRings.count(ringNode4) > 0) {
+    if (fixedRingSizes[ringNode4] > 0) {
         int currentSize = networkB.nodes[ringNode4].netConnections.size();
-        if (currentSize == fixedRings[ringNode4] + 1) {
+        if (currentSize == fixedRingSizes[ringNode4] + 1) {
             logger->debug("No valid move: Switch would violate fixed ring size");
             return false;
         }
@@ -399,9 +1505,10 @@ bool LinkedNetwork::genSwitchOperations(int baseNode1, int baseNode2, int ringNo
     //                          Break                   Make
     ringBondBreakMake = {ringNode1, ringNode2, ringNode3, ringNode4};
 
-    convexCheckIDs = {baseNode1, baseNode2, baseNode3, baseNode4, baseNode5,
-                      baseNode6, baseNode7, baseNode8, baseNode9, baseNode10,
-                      baseNode11, baseNode12, baseNode13, baseNode14};
+    shellNodes = {baseNode1, baseNode2, baseNode3, baseNode4, baseNode5,
+                  baseNode6, baseNode7, baseNode8, baseNode9, baseNode10,
+                  baseNode11, baseNode12, baseNode13, baseNode14};
+    convexCheckIDs = std::unordered_set<int>(shellNodes.begin(), shellNodes.end());
 
     if (baseNode7 == baseNode4) {
         // 4 membered ringNode2
@@ -519,15 +1626,27 @@ bool LinkedNetwork::genSwitchOperations(int baseNode1, int baseNode2, int ringNo
  * @throw std::runtime_error if the associated node cannot be found
  */
 int LinkedNetwork::findCommonConnection(const int &baseNode, const int &ringNode, const int &excludeNode) const {
-    // Find node that shares baseNode and ringNode but is not excludeNode
-    std::unordered_set<int> commonConnections = intersectVectors(networkA.nodes[baseNode].netConnections, networkB.nodes[ringNode].dualConnections);
-    commonConnections.erase(excludeNode);
-    if (commonConnections.size() != 1) {
+    // Find node that shares baseNode and ringNode but is not excludeNode, which is a neighbour whose bond runs
+    // around the ring on either side
+    int commonConnection = -1;
+    int numCommonConnections = 0;
+    if (int start = mesh.vertexEdges[baseNode]; start != -1) {
+        int halfEdge = start;
+        do {
+            int neighbour = mesh.getDestination(halfEdge);
+            if (neighbour != excludeNode && (mesh.faces[halfEdge] == ringNode || mesh.faces[halfEdge ^ 1] == ringNode)) {
+                commonConnection = neighbour;
+                numCommonConnections++;
+            }
+            halfEdge = mesh.rotationNext[halfEdge];
+        } while (halfEdge != start);
+    }
+    if (numCommonConnections != 1) {
         throw std::runtime_error("Could not find common base node for base node " + std::to_string(baseNode) +
                                  " and ring node " + std::to_string(ringNode) +
                                  " excluding node " + std::to_string(excludeNode));
     }
-    return *commonConnections.begin();
+    return commonConnection;
 }
 /**
  * @brief Find a common ring connection between two base nodes that exlcudes a given node
@@ -538,6 +1657,17 @@ int LinkedNetwork::findCommonConnection(const int &baseNode, const int &ringNode
  * @throw std::runtime_error if the associated node cannot be found
  */
 int LinkedNetwork::findCommonRing(const int &baseNode1, const int &baseNode2, const int &excludeNode) const {
+    // Bonded nodes share the rings either side of their bond
+    if (int halfEdge = mesh.findHalfEdge(baseNode1, baseNode2); halfEdge != -1) {
+        int ring1 = mesh.faces[halfEdge];
+        int ring2 = mesh.faces[halfEdge ^ 1];
+        if (ring1 != ring2 && (ring1 == excludeNode || ring2 == excludeNode)) {
+            return ring1 == excludeNode ? ring2 : ring1;
+        }
+        throw std::runtime_error("Could not find common ring node for base node " + std::to_string(baseNode1) +
+                                 " and base node " + std::to_string(baseNode2) +
+                                 " excluding ring node " + std::to_string(excludeNode));
+    }
     // Find node that shares baseNode1 and baseNode2 but is not excludeNode
     std::unordered_set<int> commonRings = intersectVectors(networkA.nodes[baseNode1].dualConnections, networkA.nodes[baseNode2].dualConnections);
     commonRings.erase(excludeNode);
@@ -549,6 +1679,158 @@ int LinkedNetwork::findCommonRing(const int &baseNode1, const int &baseNode2, co
     return *commonRings.begin();
 }
 
+/**
+ * @brief Get a key that uniquely identifies a proposal by its bond and direction. The two rings either side of a bond
+ * are fixed, so their order is enough to distinguish the two directions.
+ * @param baseNode1 the id of the first node in lattice A
+ * @param baseNode2 the id of the second node in lattice A
+ * @param ringNode1 the id of the first node in lattice B
+ * @param ringNode2 the id of the second node in lattice B
+ * @return 64 bit key of the proposal
+ */
+uint64_t LinkedNetwork::getProposalKey(const int &baseNode1, const int &baseNode2, const int &ringNode1, const int &ringNode2) const {
+    return (static_cast<uint64_t>(baseNode1) * networkA.nodes.size() + baseNode2) * 2 + (ringNode1 < ringNode2 ? 1 : 0);
+}
+
+/**
+ * @brief Calculate the Zobrist hash of the base network, the XOR of the keys of every bond
+ * @return 64 bit hash of the base network topology
+ */
+uint64_t LinkedNetwork::computeTopologyHash() const {
+    uint64_t hash = 0;
+    for (const Node &node : networkA.nodes) {
+        for (const int &cnx : node.netConnections) {
+            if (node.id < cnx) {
+                hash ^= TopologyCache::bondKey(node.id, cnx);
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief Get the value to XOR with the topology hash to apply or undo a switch move.
+ * Bonds 1-5 and 2-4 are broken and bonds 1-4 and 2-5 are made, see genSwitchOperations.
+ * @param bondBreaks the bonds to break (vector of pairs)
+ * @return XOR of the keys of the two broken and two made bonds
+ */
+uint64_t LinkedNetwork::getSwitchHashDelta(const std::vector<int> &bondBreaks) const {
+    return TopologyCache::bondKey(bondBreaks[0], bondBreaks[1]) ^ TopologyCache::bondKey(bondBreaks[2], bondBreaks[3]) ^
+           TopologyCache::bondKey(bondBreaks[0], bondBreaks[3]) ^ TopologyCache::bondKey(bondBreaks[2], bondBreaks[1]);
+}
+
+/**
+ * @brief Minimise the LAMMPS network, using the topology cache to skip or warm-start the minimisation
+ * if the LAMMPS topology has been relaxed before
+ * @param hash Zobrist hash of the LAMMPS network topology
+ * @param coords Vector to hold the relaxed coordinates as a 1D vector of pairs
+ * @param minimiserIterations Number of minimiser iterations, from the cached geometry on a hit, -1 if the minimisation was skipped
+ * @return The relaxed potential energy of the network
+ */
+double LinkedNetwork::relaxNetwork(const uint64_t &hash, std::vector<double> &coords, int &minimiserIterations) {
+    minimiserIterations = -1;
+    if (!topologyCache.isEnabled()) {
+        minimiserIterations = lammpsNetwork.minimiseNetwork();
+        lammpsNetwork.getCoords(coords, 2);
+        return lammpsNetwork.getPotentialEnergy();
+    }
+    if (const TopologyCache::Entry *entry = topologyCache.find(hash); entry != nullptr) {
+        const float *cachedCoords = topologyCache.getCoords(*entry);
+        coords.assign(cachedCoords, cachedCoords + topologyCache.entrySize);
+        lammpsNetwork.setCoords(coords, 2);
+        if (skipRelaxationOnCacheHit) {
+            // The cached coordinates are rounded to floats, so their energy is evaluated rather than taken from the cache
+            logger->debug("Topology cache hit, skipping minimisation");
+            return lammpsNetwork.evaluatePotentialEnergy();
+        }
+        logger->debug("Topology cache hit, warm-starting minimisation");
+    }
+    minimiserIterations = lammpsNetwork.minimiseNetwork();
+    lammpsNetwork.getCoords(coords, 2);
+    double relaxedEnergy = lammpsNetwork.getPotentialEnergy();
+    topologyCache.insert(hash, relaxedEnergy, coords);
+    return relaxedEnergy;
+}
+
+/**
+ * @brief Get the heatmap cell of a switch move from the midpoint of its switched bond before the switch
+ * @param move the switch move
+ * @return Index of the cell, or -1 if the heatmap is disabled
+ */
+int LinkedNetwork::getHeatmapCell(const SwitchMove &move) const {
+    if (!heatmap.isEnabled()) {
+        return -1;
+    }
+    return heatmap.getCell({currentCoords[move.baseNode1 * 2], currentCoords[move.baseNode1 * 2 + 1]},
+                           {currentCoords[move.baseNode2 * 2], currentCoords[move.baseNode2 * 2 + 1]});
+}
+
+/**
+ * @brief Get the frame of the bond being switched, with x along baseNode1 to baseNode2 and y towards ringNode2,
+ * so a template learned on one bond can be applied to any other bond of the same case
+ * @param move the switch move
+ * @return The x and y axes of the frame as unit vectors
+ */
+std::tuple<std::vector<double>, std::vector<double>> LinkedNetwork::getBondFrame(const SwitchMove &move) const {
+    std::vector<double> coord1 = {currentCoords[move.baseNode1 * 2], currentCoords[move.baseNode1 * 2 + 1]};
+    std::vector<double> coord2 = {currentCoords[move.baseNode2 * 2], currentCoords[move.baseNode2 * 2 + 1]};
+    std::vector<double> xAxis = pbcVector(coord1, coord2, dimensions);
+    double bondLength = std::hypot(xAxis[0], xAxis[1]);
+    vectorDivide(xAxis, bondLength);
+    std::vector<double> yAxis = {-xAxis[1], xAxis[0]};
+    std::vector<double> ringVector = pbcVector(coord1, networkB.nodes[move.ringNode2].crd, dimensions);
+    if ((ringVector[0] - xAxis[0] * bondLength / 2) * yAxis[0] + (ringVector[1] - xAxis[1] * bondLength / 2) * yAxis[1] < 0) {
+        vectorMultiply(yAxis, -1.0);
+    }
+    return {xAxis, yAxis};
+}
+
+/**
+ * @brief Move the shell nodes of a switched bond in LAMMPS to where previous relaxations of the same case ended up
+ * @param move the switch move, which has already been applied to LAMMPS
+ * @return true if a template was applied, false if there is no template for the case yet
+ */
+bool LinkedNetwork::applyRelaxationTemplate(const SwitchMove &move) {
+    const RelaxationTemplates::Template *relaxationTemplate = relaxationTemplates.find(move.templateCase);
+    if (relaxationTemplate == nullptr) {
+        return false;
+    }
+    auto [xAxis, yAxis] = getBondFrame(move);
+    std::unordered_set<int> movedNodes;
+    for (int i = 0; i < RelaxationTemplates::NUM_SHELL_NODES; ++i) {
+        // Small rings share shell nodes, which only need moving once
+        int nodeID = move.shellNodes[i];
+        if (!movedNodes.insert(nodeID).second || !isNodeActive(nodeID)) {
+            continue;
+        }
+        double localX = relaxationTemplate->displacements[i * 2];
+        double localY = relaxationTemplate->displacements[i * 2 + 1];
+        std::vector<double> coord = {currentCoords[nodeID * 2] + localX * xAxis[0] + localY * yAxis[0],
+                                     currentCoords[nodeID * 2 + 1] + localX * xAxis[1] + localY * yAxis[1]};
+        wrapCoords(coord);
+        lammpsNetwork.setAtomCoords(nodeID + 1, coord, 2);
+    }
+    return true;
+}
+
+/**
+ * @brief Update the template of a switch's case with how far its shell nodes moved during relaxation
+ * @param move the switch move
+ * @param coords the relaxed coordinates of the switched network as a 1D vector of pairs
+ */
+void LinkedNetwork::learnRelaxationTemplate(const SwitchMove &move, const std::vector<double> &coords) {
+    auto [xAxis, yAxis] = getBondFrame(move);
+    std::vector<double> displacements;
+    displacements.reserve(2 * RelaxationTemplates::NUM_SHELL_NODES);
+    for (const int &nodeID : move.shellNodes) {
+        std::vector<double> displacement = pbcVector({currentCoords[nodeID * 2], currentCoords[nodeID * 2 + 1]},
+                                                     {coords[nodeID * 2], coords[nodeID * 2 + 1]}, dimensions);
+        displacements.push_back(displacement[0] * xAxis[0] + displacement[1] * xAxis[1]);
+        displacements.push_back(displacement[0] * yAxis[0] + displacement[1] * yAxis[1]);
+    }
+    relaxationTemplates.learn(move.templateCase, displacements);
+}
+
 /**
  * @brief Switch the BSS network by breaking and making bonds
  * @param bondBreaks the bonds to break (vector of pairs)
@@ -601,14 +1883,26 @@ void LinkedNetwork::switchNetMCGraphene(const std::vector<int> &bondBreaks, cons
 
     nodeB3.dualConnections.emplace_back(atom2);
     nodeB4.dualConnections.emplace_back(atom1);
+
+    mesh.switchBond(atom1, atom2, atom5, atom4);
+    if (!isRingAreaStale.empty()) {
+        for (const int &ringID : ringBondBreakMake) {
+            isRingAreaStale[ringID] = true;
+        }
+    }
+
+    topologyHash ^= getSwitchHashDelta(bondBreaks);
 }
 
 /**
- * @brief Restores the initial state of the network by assigning Node objects to their initial states
+ * @brief Restores the initial state of the network by assigning Node objects to their initial states, and switches
+ * the half-edge mesh back
+ * @param bondBreaks the bonds that were broken (vector of pairs)
  * @param initialInvolvedNodesA the initial state of the nodes in network A
  * @param initialInvolvedNodesB the initial state of the nodes in network B
  */
-void LinkedNetwork::revertNetMCGraphene(const std::vector<Node> &initialInvolvedNodesA, const std::vector<Node> &initialInvolvedNodesB) {
+void LinkedNetwork::revertNetMCGraphene(const std::vector<int> &bondBreaks, const std::vector<Node> &initialInvolvedNodesA,
+                                        const std::vector<Node> &initialInvolvedNodesB) {
     // Revert changes to descriptors due to breaking connections
     for (const Node &node : initialInvolvedNodesA) {
         networkA.nodes[node.id] = node;
@@ -616,6 +1910,7 @@ void LinkedNetwork::revertNetMCGraphene(const std::vector<Node> &initialInvolved
     for (const Node &node : initialInvolvedNodesB) {
         networkB.nodes[node.id] = node;
     }
+    mesh.switchBond(bondBreaks[0], bondBreaks[2], bondBreaks[3], bondBreaks[1]);
 }
 
 /**
@@ -640,7 +1935,7 @@ void LinkedNetwork::pushCoords(const std::vector<double> &coords) {
 /**
  * @brief Checks if network is consistent and logs any inconsistencies
  * @return true if all connectivities are reciprocated and all base nodes have clockwise neighbours
- * and ring sizes that are not neighbours of fixedRings are within range, false otherwise
+ * and ring sizes that are not neighbours of fixed rings are within range, false otherwise
  */
 bool LinkedNetwork::checkConsistency() {
     logger->info("Checking consistency...");
@@ -654,9 +1949,11 @@ bool LinkedNetwork::checkConsistency() {
         });
     });
     std::unordered_set<int> fixedRingNeighbours = {};
-    std::for_each(fixedRings.begin(), fixedRings.end(), [this, &fixedRingNeighbours](const std::pair<int, int> &ring) {
-        fixedRingNeighbours.insert(networkB.nodes[ring.first].netConnections.begin(), networkB.nodes[ring.first].netConnections.end());
-    });
+    for (int ringID = 0; ringID < networkB.nodes.size(); ++ringID) {
+        if (fixedRingSizes[ringID] > 0) {
+            fixedRingNeighbours.insert(networkB.nodes[ringID].netConnections.begin(), networkB.nodes[ringID].netConnections.end());
+        }
+    }
     std::for_each(networkB.nodes.begin(), networkB.nodes.end(), [this, &consistent, &fixedRingNeighbours](const Node &node) {
         std::for_each(node.netConnections.begin(), node.netConnections.end(), [this, &node, &consistent](const int &cnx) {
             if (!vectorContains(networkB.nodes[cnx].netConnections, node.id)) {
@@ -685,9 +1982,35 @@ bool LinkedNetwork::checkConsistency() {
             }
         });
     });
+    if (!mesh.checkConsistency(networkA, networkB, logger)) {
+        consistent = false;
+    }
     return checkAllClockwiseNeighbours() && consistent;
 }
 
+/**
+ * @brief Log an estimate of the memory held by each part of the linked network
+ */
+void LinkedNetwork::logMemoryUsage() const {
+    auto numNodes = static_cast<double>(networkA.nodes.size());
+    auto logUsage = [this, &numNodes](const std::string &name, const size_t &numBytes) {
+        logger->info("{:<20} {:>8.2f} MiB {:>8.1f} B/node", name, numBytes / 1048576.0, numBytes / numNodes);
+    };
+    logger->info("Memory usage:");
+    logUsage("Base network", networkA.getMemoryUsage());
+    logUsage("Ring network", networkB.getMemoryUsage());
+    logUsage("Half-edge mesh", mesh.getMemoryUsage());
+    logUsage("Coordinates", (currentCoords.capacity() + relaxedCoords.capacity()) * sizeof(double));
+    // The distribution holds its own probabilities and cumulative sums alongside the weights
+    logUsage("Selection weights", 3 * weights.capacity() * sizeof(double));
+    logUsage("Topology cache", topologyCache.getMemoryUsage());
+    if (topologyCache.isMapped) {
+        logUsage("Mapped cache file", topologyCache.mappedCoords.getNumBytes());
+    }
+    logUsage("Proposal outcomes", proposalOutcomes.size() * (sizeof(std::pair<uint64_t, ProposalOutcome>) + sizeof(void *)) +
+                                      proposalOutcomes.bucket_count() * sizeof(void *));
+}
+
 /**
  * @brief Wraps coordinates out of bounds back into the periodic box, only for 2 dimensions
  * @param coords Coordinates to be wrapped (1D vector of pairs)
@@ -702,10 +2025,83 @@ void LinkedNetwork::wrapCoords(std::vector<double> &coords) const {
 
 /**
  * @brief Writes the network to files
+ * @param directory The folder to write the files to, which must exist
 */
-void LinkedNetwork::write() const {
-    networkA.write();
-    networkB.write();
+void LinkedNetwork::write(const std::string &directory) const {
+    if (baseNodeOrder.empty()) {
+        networkA.write(directory);
+        networkB.write(directory);
+        return;
+    }
+    Network baseNetwork;
+    Network ringNetwork;
+    getOriginalNetworks(baseNetwork, ringNetwork);
+    baseNetwork.write(directory);
+    ringNetwork.write(directory);
+}
+
+/**
+ * @brief Adds the current network to the movie
+ */
+void LinkedNetwork::writeMovieFrame() {
+    if (frameRenderer) {
+        frameRenderer->capture(networkA, networkB);
+    } else {
+        lammpsNetwork.writeMovie();
+    }
+}
+
+/**
+ * @brief Finishes the movie, waiting for the native renderer to write its remaining frames
+ */
+void LinkedNetwork::stopMovie() {
+    if (!writeMovie) {
+        return;
+    }
+    if (frameRenderer) {
+        try {
+            frameRenderer->finish();
+            logger->info("Wrote {} movie frames to {}", frameRenderer->numFrames, frameRenderer->directory);
+        } catch (const std::exception &e) {
+            logger->error("Failed to write movie frames: {}", e.what());
+        }
+        frameRenderer.reset();
+    } else {
+        lammpsNetwork.stopMovie();
+    }
+    writeMovie = false;
+}
+
+/**
+ * @brief Writes the LAMMPS data file with the original node IDs and every bond and angle. LAMMPS holds the
+ * renumbered network without the interactions among frozen atoms, so it is switched to the original numbering
+ * and full topology for writing and back again afterwards.
+ */
+void LinkedNetwork::writeLammpsData() {
+    if (baseNodeOrder.empty() && activeNodes.empty()) {
+        lammpsNetwork.writeData();
+        return;
+    }
+    Network baseNetwork;
+    Network ringNetwork;
+    getOriginalNetworks(baseNetwork, ringNetwork);
+    std::vector<double> originalCoords;
+    originalCoords.reserve(2 * baseNetwork.nodes.size());
+    for (const Node &node : baseNetwork.nodes) {
+        originalCoords.insert(originalCoords.end(), node.crd.begin(), node.crd.end());
+    }
+    std::vector<int> bonds;
+    std::vector<int> angles;
+    baseNetwork.getBondsAndAngles(bonds, angles);
+    lammpsNetwork.setCoords(originalCoords, 2);
+    lammpsNetwork.rebuildTopology(bonds, angles, false);
+    lammpsNetwork.writeData();
+
+    bonds.clear();
+    angles.clear();
+    networkA.getBondsAndAngles(bonds, angles);
+    lammpsNetwork.setCoords(currentCoords, 2);
+    lammpsNetwork.rebuildTopology(bonds, angles);
 }
 
 /**
@@ -966,19 +2362,68 @@ std::tuple<std::vector<double>, std::vector<double>> LinkedNetwork::rotateBond(c
  * @brief Gets the areas of all rings in the network
  * @return Vector of areas of all rings
  */
-std::vector<double> LinkedNetwork::getRingAreas() const {
-    std::vector<double> ringAreas;
-    ringAreas.reserve(networkB.nodes.size());
-    for (size_t ringNodeID = 0; ringNodeID < networkB.nodes.size(); ringNodeID++) {
-        std::vector<std::vector<double>> baseNodeCoords;
-        baseNodeCoords.reserve(networkB.nodes[ringNodeID].dualConnections.size());
-        for (size_t baseNodeID : networkB.nodes[ringNodeID].dualConnections) {
-            std::vector<double> pbcVec = pbcVector({currentCoords[baseNodeID * 2], currentCoords[baseNodeID * 2 + 1]},
-                                                   {currentCoords[ringNodeID * 2], currentCoords[ringNodeID * 2 + 1]}, dimensions);
-            baseNodeCoords.push_back(pbcVec);
+const std::vector<double> &LinkedNetwork::getRingAreas() {
+    refreshRingAreas();
+    return ringAreas;
+}
+
+/**
+ * @brief Gets the perimeters of all rings in the network
+ * @return Vector of perimeters of all rings
+ */
+const std::vector<double> &LinkedNetwork::getRingPerimeters() {
+    refreshRingAreas();
+    return ringPerimeters;
+}
+
+/**
+ * @brief Remeasure the area and perimeter of every ring whose nodes have changed, or that has a node that has moved
+ * further than ringAreaTolerance since it was last measured. Only the coordinates of nodes that moved that far are
+ * recorded again, so a ring is never more than twice the tolerance out of date.
+ */
+void LinkedNetwork::refreshRingAreas() {
+    if (ringAreas.size() != networkB.nodes.size()) {
+        ringAreas.assign(networkB.nodes.size(), 0.0);
+        ringPerimeters.assign(networkB.nodes.size(), 0.0);
+        isRingAreaStale.assign(networkB.nodes.size(), true);
+        ringAreaCoords = currentCoords;
+    }
+    double squareTolerance = ringAreaTolerance * ringAreaTolerance;
+    for (int nodeID = 0; nodeID < networkA.nodes.size(); ++nodeID) {
+        std::vector<double> displacement = pbcVector({ringAreaCoords[2 * nodeID], ringAreaCoords[2 * nodeID + 1]},
+                                                     {currentCoords[2 * nodeID], currentCoords[2 * nodeID + 1]}, dimensions);
+        if (displacement[0] * displacement[0] + displacement[1] * displacement[1] > squareTolerance) {
+            ringAreaCoords[2 * nodeID] = currentCoords[2 * nodeID];
+            ringAreaCoords[2 * nodeID + 1] = currentCoords[2 * nodeID + 1];
+            for (const int &ringID : networkA.nodes[nodeID].dualConnections) {
+                isRingAreaStale[ringID] = true;
+            }
         }
-        double ringArea = calculatePolygonArea(baseNodeCoords);
-        ringAreas.push_back(ringArea);
     }
-    return ringAreas;
+    for (int ringID = 0; ringID < ringAreas.size(); ++ringID) {
+        if (isRingAreaStale[ringID]) {
+            ringAreas[ringID] = mesh.getFaceArea(ringID, currentCoords, dimensions);
+            ringPerimeters[ringID] = mesh.getFacePerimeter(ringID, currentCoords, dimensions);
+            isRingAreaStale[ringID] = false;
+        }
+    }
+}
+
+/**
+ * @brief Gets the mean area of the rings of every size
+ * @return Map of ring size to mean area
+ */
+std::map<int, double> LinkedNetwork::getMeanRingAreas() {
+    refreshRingAreas();
+    std::map<int, double> meanAreas;
+    std::map<int, int> ringCounts;
+    for (int ringID = 0; ringID < ringAreas.size(); ++ringID) {
+        int ringSize = networkB.nodes[ringID].dualConnections.size();
+        meanAreas[ringSize] += ringAreas[ringID];
+        ringCounts[ringSize]++;
+    }
+    for (auto &[ringSize, area] : meanAreas) {
+        area /= ringCounts[ringSize];
+    }
+    return meanAreas;
 }
\ No newline at end of file
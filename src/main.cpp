@@ -1,23 +1,47 @@
+#include "equilibration_detector.h"
 #include "input_data.h"
+#include "job_server.h"
 #include "linked_network.h"
 #include "output_file.h"
 #include "spdlog/sinks/basic_file_sink.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
+#include "wang_landau.h"
 #include <ctime>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
 #include <sstream>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <signal.h>
 #include <atomic>
+#include <thread>
 
 // Global exit flag to cleanly exit when we use Cntrl + C
 std::atomic<bool> exitFlag(false);
-// Set start time so we can calculate the total run time
-const auto start = std::chrono::high_resolution_clock::now();
+
+using TimePoint = std::chrono::high_resolution_clock::time_point;
+
+// Equilibration of a stage, written to stage_equilibration.csv
+struct StageEquilibration {
+    std::string stage;
+    int equilibrationStep;
+    double effectiveSamples;
+    int stepsRun;
+    int stepsRequested;
+};
+
+// Releases a LAMMPS instance when it goes out of scope, so the next job of a job server worker reuses it however the
+// job ends
+struct LammpsReleaser {
+    LammpsObject &lammpsObject;
+
+    ~LammpsReleaser() {
+        lammpsObject.release();
+    }
+};
 
 /**
  * @brief Signal handler to set the exit flag to true when we use Cntrl + C
@@ -27,12 +51,38 @@ void exitFlagger(int sig) {
     exitFlag = true;
 }
 
+/**
+ * @brief Writes the header of a statistics file
+ * @param allStatsFile The file to write the header to
+*/
+void writeStatsHeader(OutputFile &allStatsFile) {
+    allStatsFile.writeDatetime("Written by Bond-Switch-Simulator by Marshall Hunt, Wilson Group, 2024)");
+    allStatsFile.writeLine("The data is structured as follows: Each value is comma separated, with inner vectors having their elements separated by semi-colons");
+    allStatsFile.writeLine("Step, Temperature, Energy, Entropy, Pearson's Coefficient, Aboave Weaire, Ring Size Distribution (vector), Mean Ring Area by Ring Size (vector)");
+}
+
+/**
+ * @brief Writes a line of the statistics file for the current state of a network
+ * @param linkedNetwork The linked network to write statistics for
+ * @param allStatsFile The file to write the statistics to
+ * @param temperature The temperature of the last step
+*/
+void writeStatsLine(LinkedNetwork &linkedNetwork, OutputFile &allStatsFile, const double &temperature) {
+    linkedNetwork.networkB.refreshStatistics();
+    allStatsFile.writeValues(linkedNetwork.numSwitches, temperature, linkedNetwork.energy,
+                             linkedNetwork.networkB.entropy, linkedNetwork.networkB.pearsonsCoeff,
+                             linkedNetwork.networkB.getAboavWeaire(), linkedNetwork.networkB.nodeSizes,
+                             linkedNetwork.getMeanRingAreas());
+}
+
 /**
  * @brief Writes the footer of the statistics file
  * @param linkedNetwork The linked network to write statistics for
  * @param allStatsFile The file to write the statistics to
+ * @param networkConsistent Whether the network passed its consistency checks
+ * @param start When the job started
 */
-void writeStatsFooter(LinkedNetwork &linkedNetwork, OutputFile &allStatsFile, const bool &networkConsistent) {
+void writeStatsFooter(LinkedNetwork &linkedNetwork, OutputFile &allStatsFile, const bool &networkConsistent, const TimePoint &start) {
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start) / 1000.0;
         allStatsFile.writeLine("The following line is a few statistics about the simulation");
@@ -50,24 +100,32 @@ void writeStatsFooter(LinkedNetwork &linkedNetwork, OutputFile &allStatsFile, co
 }
 
 /**
- * @brief Cleans up the simulation by writing the network files and stopping the LAMMPS movie
- * @param linkedNetwork The linked network to clean up
+ * @brief Writes the equilibration of each stage to stage_equilibration.csv, if any stage was checked. The statistics
+ * file keeps its footer as its last line for the analysis scripts.
+ * @param stageEquilibrations The equilibration of each stage checked
+ * @param directory The directory to write the file to
 */
-void cleanup(LinkedNetwork &linkedNetwork, OutputFile &allStatsFile){
-    linkedNetwork.lammpsNetwork.stopMovie();
-    linkedNetwork.write();
-    linkedNetwork.lammpsNetwork.writeData();
-    std::filesystem::remove("./log.lammps");
-    writeStatsFooter(linkedNetwork, allStatsFile, linkedNetwork.checkConsistency());
-    spdlog::shutdown();
+void writeStageEquilibrations(const std::vector<StageEquilibration> &stageEquilibrations, const std::string &directory) {
+    if (stageEquilibrations.empty()) {
+        return;
+    }
+    OutputFile equilibrationFile(std::filesystem::path(directory) / "stage_equilibration.csv");
+    equilibrationFile.writeDatetime("Written by Bond-Switch-Simulator by Marshall Hunt, Wilson Group, 2024)");
+    equilibrationFile.writeLine("The equilibration of each stage, with an equilibration step of -1 if it was not detected");
+    equilibrationFile.writeLine("Stage, Equilibration step, Effective sample size, Steps run, Steps requested");
+    for (const StageEquilibration &stage : stageEquilibrations) {
+        equilibrationFile.writeValues(stage.stage, stage.equilibrationStep, stage.effectiveSamples, stage.stepsRun, stage.stepsRequested);
+    }
 }
 
 /**
  * @brief Initialises the logger by creating a file sink and a console sink
+ * @param logPath The path of the log file
+ * @param isDebug Whether to log debug messages
 */
-LoggerPtr initialiseLogger(int argc, char *argv[]) {
+LoggerPtr initialiseLogger(const std::string &logPath, const bool &isDebug) {
     // Create a file sink and a console sink with different names for clarity
-    auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(std::filesystem::path("./output_files") / "bond_switch_simulator.log" , true);
+    auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logPath, true);
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
 
     // Combine the sinks into a multi-sink logger
@@ -76,47 +134,62 @@ LoggerPtr initialiseLogger(int argc, char *argv[]) {
     logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
 
     // Set the default log level to info
-    logger->set_level(spdlog::level::info);
-
-    // Check command line arguments for --debug flag
-    int opt;
-    while ((opt = getopt(argc, argv, "d")) != -1) {
-        if (opt == 'd') {
-            logger->set_level(spdlog::level::debug);
-            logger->debug("Debug messages enabled");
-            break;
-        }
-    }
+    logger->set_level(isDebug ? spdlog::level::debug : spdlog::level::info);
+    logger->debug("Debug messages enabled");
     return logger;
 }
 
 /**
- * @brief Attempts to switch the network at each temperature given in expTemperature
+ * @brief Attempts to switch the network at each temperature given in expTemperature, stopping early if the
+ * detector finds the stage equilibrated
+ * @param stage The name of the stage, for logging
  * @param expTemperatures The temperatures to switch at in raw form
  * @param linkedNetwork The linked network to switch
  * @param allStatsFile The file to write the statistics to
+ * @param heatmapFile The file to write the switch heatmap to, or nullptr if the heatmap is disabled
  * @param writeInterval The interval to write the statistics
+ * @param detector The equilibration detector of the stage, sampled at every write
+ * @param stageEquilibrations The equilibration of each stage, added to if the detector is enabled
  * @param logger The logger to log to
  */
-void runSimulation(const std::vector<double> &expTemperatures, LinkedNetwork &linkedNetwork,
-                   OutputFile &allStatsFile, const int &writeInterval, const LoggerPtr &logger) {
+void runSimulation(const std::string &stage, const std::vector<double> &expTemperatures, LinkedNetwork &linkedNetwork,
+                   OutputFile &allStatsFile, OutputFile *heatmapFile, const int &writeInterval, EquilibrationDetector &detector,
+                   std::vector<StageEquilibration> &stageEquilibrations, const LoggerPtr &logger) {
     if (expTemperatures.empty()) {
         logger->warn("No temperatures given, simulation not run");
         return;
     }
     double completion = 0.0;
-    for (size_t i = 1; i <= expTemperatures.size(); ++i) {
+    size_t i = 1;
+    for (; i <= expTemperatures.size(); ++i) {
         if (exitFlag) {
-            logger->warn("Caught SIGINT, exiting...");
-            cleanup(linkedNetwork, allStatsFile);
-            exit(0);
+            // runJob writes the network so far, then reports the interruption
+            logger->warn("Caught SIGINT, stopping {}...", stage);
+            --i;
+            break;
         }
         linkedNetwork.monteCarloSwitchMoveLAMMPS(expTemperatures[i - 1]);
+        if (linkedNetwork.topologyAuditInterval > 0 && i % linkedNetwork.topologyAuditInterval == 0) {
+            linkedNetwork.auditLammpsTopology();
+        }
         if (i % writeInterval == 0) {
-            linkedNetwork.networkB.refreshStatistics();
-            allStatsFile.writeValues(linkedNetwork.numSwitches, expTemperatures[i - 1], linkedNetwork.energy,
-                                     linkedNetwork.networkB.entropy, linkedNetwork.networkB.pearsonsCoeff,
-                                     linkedNetwork.networkA.getAboavWeaire(), linkedNetwork.networkB.nodeSizes);
+            writeStatsLine(linkedNetwork, allStatsFile, expTemperatures[i - 1]);
+            if (heatmapFile != nullptr) {
+                linkedNetwork.heatmap.write(*heatmapFile, linkedNetwork.numSwitches);
+            }
+            if (detector.isEnabled) {
+                std::vector<double> observables = {linkedNetwork.energy, linkedNetwork.networkB.entropy};
+                for (int ringSize = linkedNetwork.minRingSize; ringSize <= linkedNetwork.maxRingSize; ++ringSize) {
+                    auto it = linkedNetwork.networkB.nodeSizes.find(ringSize);
+                    observables.push_back(it == linkedNetwork.networkB.nodeSizes.end() ? 0.0 : it->second);
+                }
+                detector.addSample(linkedNetwork.numSwitches, observables);
+                if (detector.check()) {
+                    logger->info("{} equilibrated at step {} with an effective sample size of {:.0f}, stopping after {} of {} steps",
+                                 stage, detector.equilibrationStep, detector.effectiveSamples, i, expTemperatures.size());
+                    break;
+                }
+            }
         }
         double currentCompletion = std::floor(static_cast<double>(i) / expTemperatures.size() / 0.1);
         if (currentCompletion > completion) {
@@ -124,98 +197,379 @@ void runSimulation(const std::vector<double> &expTemperatures, LinkedNetwork &li
             logger->info("{:.0f}% Complete", completion * 10);
         }
     }
+    if (detector.isEnabled) {
+        stageEquilibrations.push_back({stage, detector.equilibrationStep, detector.effectiveSamples,
+                                       static_cast<int>(std::min(i, expTemperatures.size())), static_cast<int>(expTemperatures.size())});
+    }
 }
 
-int main(int argc, char *argv[]) {
-    // Set up signal handler to cleanly exit when we use Cntrl + C
-    signal(SIGINT, exitFlagger);
-    LoggerPtr logger;
-    try {
-        logger = initialiseLogger(argc, argv);
-    } catch (std::exception &e) {
-        std::cerr << "Exception while initialising logger: " << e.what() << std::endl;
-        return 1;
+/**
+ * @brief Attempts to switch several independent replicas of the network at each temperature given in expTemperatures,
+ * with all of their LAMMPS networks packed into one instance. Every step makes one move in each replica, relaxes them
+ * in a single minimisation, then accepts or rejects each move on the energy of its own replica.
+ * @param inputData The input data, giving the number of replicas
+ * @param expTemperatures The temperatures of thermalisation then annealing in raw form
+ * @param linkedNetwork The linked network of the first replica, whose statistics go to allStatsFile
+ * @param allStatsFile The file to write the statistics of the first replica to
+ * @param start When the job started, for the footers of the other replicas
+ * @param logger The logger to log to
+ * @throw std::runtime_error if the potential commands are not known or an output folder cannot be created
+ */
+void runPackedReplicas(const InputData &inputData, const std::vector<double> &expTemperatures, LinkedNetwork &linkedNetwork,
+                       OutputFile &allStatsFile, const TimePoint &start, const LoggerPtr &logger) {
+    if (expTemperatures.empty()) {
+        logger->warn("No temperatures given, simulation not run");
+        return;
+    }
+    if (linkedNetwork.lammpsNetwork.potentialCommands.empty()) {
+        throw std::runtime_error("Packed replicas need the potential commands in lammps_potential.txt");
+    }
+    const int numReplicas = inputData.packedReplicas;
+    LammpsObject packedNetwork(linkedNetwork.networkA, linkedNetwork.lammpsNetwork.potentialCommands, numReplicas, logger);
+    packedNetwork.setAtomSortInterval(inputData.atomSortInterval);
+    std::vector<std::unique_ptr<LinkedNetwork>> extraReplicas;
+    std::vector<std::unique_ptr<OutputFile>> extraStatsFiles;
+    for (int i = 1; i < numReplicas; ++i) {
+        extraReplicas.push_back(std::make_unique<LinkedNetwork>(linkedNetwork, packedNetwork.getReplica(i, numReplicas)));
+        extraReplicas.back()->randomNumGen.seed(inputData.randomSeed + i);
+        extraReplicas.back()->metropolisCondition = Metropolis(inputData.randomSeed + i);
+        std::filesystem::path directory = std::filesystem::path("./output_files") / ("replica_" + std::to_string(i));
+        if (!std::filesystem::exists(directory) && !std::filesystem::create_directory(directory)) {
+            throw std::runtime_error("Error creating output folder " + directory.string());
+        }
+        extraStatsFiles.push_back(std::make_unique<OutputFile>(directory / "bss_stats.csv"));
+        writeStatsHeader(*extraStatsFiles.back());
+    }
+    std::vector<LinkedNetwork *> replicas = {&linkedNetwork};
+    std::vector<OutputFile *> statsFiles = {&allStatsFile};
+    for (int i = 0; i < numReplicas - 1; ++i) {
+        replicas.push_back(extraReplicas[i].get());
+        statsFiles.push_back(extraStatsFiles[i].get());
     }
-    try {
-        logger->info("Bond Switch Simulator");
-        logger->info("Written by Marshall Hunt (Part II), Wilson Group, 2024");
 
-        // Read input file
-        InputData inputData(std::filesystem::path("./input_files") /"bss_parameters.txt", logger);
-        // Check if output folder already exists
-        if (std::filesystem::exists("./output_files")) {
-            logger->warn("Output folder already exists, files will be overwritten!");
-        } else {
-            // Try to create output folder
-            if (!std::filesystem::create_directory("./output_files")) {
-                logger->error("Error creating output folder");
-                return 1;
+    linkedNetwork.usePackedLammps(packedNetwork.getReplica(0, numReplicas));
+    const size_t numNodes = linkedNetwork.networkA.nodes.size();
+
+    std::vector<SwitchMove> moves(numReplicas);
+    std::vector<double> packedCoords;
+    std::vector<double> packedAtomEnergies;
+    double completion = 0.0;
+    for (size_t step = 1; step <= expTemperatures.size() && !exitFlag; ++step) {
+        for (int i = 0; i < numReplicas; ++i) {
+            moves[i] = replicas[i]->startPackedSwitchMove();
+        }
+        packedNetwork.minimiseNetwork();
+        packedNetwork.getCoords(packedCoords, 2);
+        packedNetwork.getAtomEnergies(packedAtomEnergies);
+        for (int i = 0; i < numReplicas; ++i) {
+            LinkedNetwork &replica = *replicas[i];
+            replica.relaxedCoords.assign(packedCoords.begin() + 2 * i * numNodes, packedCoords.begin() + 2 * (i + 1) * numNodes);
+            double finalEnergy = std::accumulate(packedAtomEnergies.begin() + i * numNodes, packedAtomEnergies.begin() + (i + 1) * numNodes, 0.0);
+            replica.finishPackedSwitchMove(moves[i], finalEnergy, expTemperatures[step - 1]);
+        }
+        if (inputData.analysisWriteInterval > 0 && step % inputData.analysisWriteInterval == 0) {
+            for (int i = 0; i < numReplicas; ++i) {
+                writeStatsLine(*replicas[i], *statsFiles[i], expTemperatures[step - 1]);
+            }
+        }
+        double currentCompletion = std::floor(static_cast<double>(step) / expTemperatures.size() / 0.1);
+        if (currentCompletion > completion) {
+            completion = currentCompletion;
+            logger->info("{:.0f}% Complete", completion * 10);
+        }
+    }
+    if (exitFlag) {
+        logger->warn("Caught SIGINT, writing the replicas so far...");
+    }
+
+    for (int i = 1; i < numReplicas; ++i) {
+        LinkedNetwork &replica = *replicas[i];
+        replica.write(std::filesystem::path("./output_files") / ("replica_" + std::to_string(i)));
+        writeStatsFooter(replica, *statsFiles[i], replica.checkConsistency(), start);
+        logger->info("Replica {} final energy: {:.3f} Hartrees, Monte Carlo acceptance: {:.3f}", i, replica.energy,
+                     (double)replica.numAcceptedSwitches / replica.numSwitches);
+    }
+}
+
+/**
+ * @brief Estimates the density of states with Wang-Landau sampling in place of thermalisation and annealing. Every
+ * walker runs on its own thread with its own network and LAMMPS instance, and they share one density of states.
+ * @param inputData The input data, giving the walkers and the bins
+ * @param linkedNetwork The linked network of the first walker
+ * @param logger The logger to log to
+ * @throw std::exception rethrown from the first walker to fail
+ */
+void runWangLandau(const InputData &inputData, LinkedNetwork &linkedNetwork, const LoggerPtr &logger) {
+    WangLandau wangLandau(inputData.wangLandauOrderParameter, linkedNetwork.energy, inputData.wangLandauMinimum,
+                          inputData.wangLandauMaximum, inputData.wangLandauBins, inputData.wangLandauFlatness,
+                          inputData.wangLandauFinalModification, inputData.minRingSize, inputData.maxRingSize, logger);
+    std::vector<std::unique_ptr<LinkedNetwork>> extraWalkers;
+    for (int i = 1; i < inputData.wangLandauWalkers; ++i) {
+        extraWalkers.push_back(std::make_unique<LinkedNetwork>(inputData, logger));
+        extraWalkers.back()->randomNumGen.seed(inputData.randomSeed + i);
+    }
+    std::vector<LinkedNetwork *> walkers = {&linkedNetwork};
+    for (const auto &walker : extraWalkers) {
+        walkers.push_back(walker.get());
+    }
+
+    double temperature = pow(10, inputData.thermalisationTemperature);
+    std::vector<std::exception_ptr> errors(walkers.size());
+    // Set when a walker fails, kept apart from exitFlag so a failed job does not stop a server worker
+    std::atomic<bool> isWalkerFailed(false);
+    auto walk = [&](const size_t &walkerIndex) {
+        try {
+            LinkedNetwork &walker = *walkers[walkerIndex];
+            for (int step = 1; step <= inputData.wangLandauMaxSteps && !exitFlag && !isWalkerFailed && !wangLandau.isConverged(); ++step) {
+                walker.wangLandauSwitchMove(wangLandau, temperature);
+                if (walker.topologyAuditInterval > 0 && step % walker.topologyAuditInterval == 0) {
+                    walker.auditLammpsTopology();
+                }
             }
+        } catch (...) {
+            errors[walkerIndex] = std::current_exception();
+            // Stop the other walkers rather than leave them sampling without this one
+            isWalkerFailed = true;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < walkers.size(); ++i) {
+        threads.emplace_back(walk, i);
+    }
+    walk(0);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
         }
+    }
+    if (exitFlag) {
+        logger->warn("Caught SIGINT, writing the Wang-Landau estimate so far...");
+    }
+    if (wangLandau.isConverged()) {
+        logger->info("Wang-Landau sampling converged after {} iterations", wangLandau.numIterations);
+    } else {
+        logger->warn("Wang-Landau sampling stopped after {} iterations with ln f = {:.2e}", wangLandau.numIterations, wangLandau.lnModification);
+    }
+    // The walkers other than the first only contribute to the density of states
+    for (const auto &walker : extraWalkers) {
+        linkedNetwork.numSwitches += walker->numSwitches;
+        linkedNetwork.numAcceptedSwitches += walker->numAcceptedSwitches;
+        linkedNetwork.failedAngleChecks += walker->failedAngleChecks;
+        linkedNetwork.failedBondLengthChecks += walker->failedBondLengthChecks;
+        linkedNetwork.failedEnergyChecks += walker->failedEnergyChecks;
+        linkedNetwork.heatmap.add(walker->heatmap);
+        walker->lammpsNetwork.close();
+    }
+
+    // Thermodynamics at temperatures spanning the thermalisation and annealing temperatures, evenly in 10^x
+    double lowestTemperature = std::min({inputData.thermalisationTemperature, inputData.annealingStartTemperature, inputData.annealingEndTemperature});
+    double highestTemperature = std::max({inputData.thermalisationTemperature, inputData.annealingStartTemperature, inputData.annealingEndTemperature});
+    const int numTemperatures = highestTemperature > lowestTemperature ? 50 : 1;
+    std::vector<double> temperatures;
+    for (int i = 0; i < numTemperatures; ++i) {
+        temperatures.push_back(pow(10, lowestTemperature + (numTemperatures > 1 ? i * (highestTemperature - lowestTemperature) / (numTemperatures - 1) : 0.0)));
+    }
+    wangLandau.write("./output_files", temperatures);
+}
+
+/**
+ * @brief Runs a simulation in the current directory, reading ./input_files and writing ./output_files
+ * @param inputData The input data of the simulation
+ * @param logger The logger to log to
+ * @throw std::runtime_error if the output folder cannot be created or the simulation fails
+ * @throw JobInterrupted if SIGINT stopped the simulation early, after the network so far has been written
+ */
+void runJob(const InputData &inputData, const LoggerPtr &logger) {
+    TimePoint start = std::chrono::high_resolution_clock::now();
+    std::vector<StageEquilibration> stageEquilibrations;
+
+    // Check if output folder already exists
+    if (std::filesystem::exists("./output_files")) {
+        logger->warn("Output folder already exists, files will be overwritten!");
+    } else if (!std::filesystem::create_directory("./output_files")) {
+        throw std::runtime_error("Error creating output folder");
+    }
 
-        // Initialise linkedNetwork
-        logger->debug("Initialising linkedNetwork...");
+    // Initialise linkedNetwork
+    logger->debug("Initialising linkedNetwork...");
 
-        LinkedNetwork linkedNetwork;
-        logger->debug("Loading linkedNetwork from files...");
-        linkedNetwork = LinkedNetwork(inputData, logger);
+    LinkedNetwork linkedNetwork;
+    // Keep LAMMPS running for the next job of a job server worker
+    LammpsReleaser lammpsReleaser{linkedNetwork.lammpsNetwork};
+    logger->debug("Loading linkedNetwork from files...");
+    linkedNetwork = LinkedNetwork(inputData, logger);
 
-        logger->debug("Network initialised!");
-        logger->info("Initial energy: {:.3f} Hartrees", linkedNetwork.energy);
+    logger->debug("Network initialised!");
+    logger->info("Initial energy: {:.3f} Hartrees", linkedNetwork.energy);
 
-        // Initialise output files
-        logger->debug("Initialising analysis output file...");
+    // Initialise output files
+    logger->debug("Initialising analysis output file...");
 
-        OutputFile allStatsFile(std::filesystem::path("./output_files") / "bss_stats.csv");
-        allStatsFile.writeDatetime("Written by Bond-Switch-Simulator by Marshall Hunt, Wilson Group, 2024)");
-        allStatsFile.writeLine("The data is structured as follows: Each value is comma separated, with inner vectors having their elements separated by semi-colons");
-        allStatsFile.writeLine("Step, Temperature, Energy, Entropy, Pearson's Coefficient, Aboave Weaire, Ring Size Distribution (vector), Ring Areas (vector)");
+    OutputFile allStatsFile(std::filesystem::path("./output_files") / "bss_stats.csv");
+    writeStatsHeader(allStatsFile);
 
+    std::unique_ptr<OutputFile> heatmapFile;
+    if (linkedNetwork.heatmap.isEnabled()) {
+        heatmapFile = std::make_unique<OutputFile>(std::filesystem::path("./output_files") / "bss_heatmap.csv");
+        heatmapFile->writeDatetime("Written by Bond-Switch-Simulator by Marshall Hunt, Wilson Group, 2024)");
+        heatmapFile->writeLine("Counts of the switches whose bond midpoint lies in every cell of a " + std::to_string(inputData.heatmapGridSize) + " x " +
+                               std::to_string(inputData.heatmapGridSize) + " grid over the box, so far at each step");
+        heatmapFile->writeLine("Each array is headed by its step and name, with rows from the lowest y and columns from the lowest x");
+    }
+
+    // Wang-Landau sampling replaces thermalisation and annealing
+    if (inputData.isWangLandauEnabled) {
+        logger->info("Running Wang-Landau sampling with {} walkers...", inputData.wangLandauWalkers);
+        runWangLandau(inputData, linkedNetwork, logger);
+        if (heatmapFile != nullptr) {
+            linkedNetwork.heatmap.write(*heatmapFile, linkedNetwork.numSwitches);
+        }
+    }
+    int thermalisationSteps = inputData.isWangLandauEnabled ? 0 : inputData.thermalisationSteps;
+    int annealingSteps = inputData.isWangLandauEnabled ? 0 : inputData.annealingSteps;
+
+    std::vector<double> thermalisationTemperatures(thermalisationSteps, pow(10, inputData.thermalisationTemperature));
+    std::vector<double> annealingTemperatures;
+    annealingTemperatures.reserve(annealingSteps);
+    double temperatureIncrement = (inputData.annealingEndTemperature - inputData.annealingStartTemperature) / (annealingSteps - 1);
+    for (int i = 0; i < annealingSteps; ++i) {
+        double temperature = inputData.annealingStartTemperature + i * temperatureIncrement;
+        annealingTemperatures.push_back(pow(10, temperature));
+    }
+
+    if (inputData.packedReplicas > 1) {
+        // Thermalisation and annealing run together, as every replica steps through the same temperatures
+        logger->info("Thermalising and annealing {} packed replicas...", inputData.packedReplicas);
+        std::vector<double> temperatures = thermalisationTemperatures;
+        temperatures.insert(temperatures.end(), annealingTemperatures.begin(), annealingTemperatures.end());
+        runPackedReplicas(inputData, temperatures, linkedNetwork, allStatsFile, start, logger);
+    } else {
         // Run monte carlo thermalisation
-        std::vector<double> thermalisationTemperatures(inputData.thermalisationSteps, pow(10, inputData.thermalisationTemperature));
         logger->info("Thermalising...");
-        runSimulation(thermalisationTemperatures, linkedNetwork, allStatsFile, inputData.analysisWriteInterval, logger);
+        EquilibrationDetector thermalisationDetector(inputData.stopWhenEquilibrated, inputData.equilibrationEffectiveSamples, inputData.equilibrationTolerance);
+        runSimulation("Thermalisation", thermalisationTemperatures, linkedNetwork, allStatsFile, heatmapFile.get(), inputData.analysisWriteInterval,
+                      thermalisationDetector, stageEquilibrations, logger);
 
         // Run monte carlo annealing
-        std::vector<double> annealingTemperatures;
-        annealingTemperatures.reserve(inputData.annealingSteps);
-        double temperatureIncrement = (inputData.annealingEndTemperature - inputData.annealingStartTemperature) / (inputData.annealingSteps - 1);
-        for (int i = 0; i < inputData.annealingSteps; ++i) {
-            double temperature = inputData.annealingStartTemperature + i * temperatureIncrement;
-            annealingTemperatures.push_back(pow(10, temperature));
+        logger->info("Annealing...");
+        EquilibrationDetector annealingDetector(inputData.stopWhenEquilibrated, inputData.equilibrationEffectiveSamples, inputData.equilibrationTolerance);
+        runSimulation("Annealing", annealingTemperatures, linkedNetwork, allStatsFile, heatmapFile.get(), inputData.analysisWriteInterval,
+                      annealingDetector, stageEquilibrations, logger);
+    }
+    logger->info("Simulation complete!");
+    linkedNetwork.stopMovie();
+
+    logger->debug("Writing final network files...");
+    linkedNetwork.syncLammpsNetwork();
+    linkedNetwork.write("./output_files");
+    // A packed instance holds every replica, so its data file would not describe this network alone
+    if (inputData.packedReplicas == 1) {
+        linkedNetwork.writeLammpsData();
+    }
+    if (linkedNetwork.topologyAuditInterval > 0) {
+        linkedNetwork.auditLammpsTopology();
+        logger->info("LAMMPS topology matches the network");
+    }
+    bool networkConsistent = linkedNetwork.checkConsistency();
+    logger->info("");
+    logger->info("Number of attempted switches: {}", linkedNetwork.numSwitches);
+    logger->info("Number of accepted switches: {}", linkedNetwork.numAcceptedSwitches);
+    logger->info("Number of failed switches due to angle: {}", linkedNetwork.failedAngleChecks);
+    logger->info("Number of failed switches due to bond length: {}", linkedNetwork.failedBondLengthChecks);
+    logger->info("Number of failed switches due to energy: {}", linkedNetwork.failedEnergyChecks);
+    logger->info("");
+    logger->info("Monte Carlo acceptance: {:.3f}", (double)linkedNetwork.numAcceptedSwitches / linkedNetwork.numSwitches);
+    if (linkedNetwork.topologyCache.isEnabled()) {
+        logger->info("Topology cache hits: {} misses: {} hit rate: {:.3f}", linkedNetwork.topologyCache.hits,
+                     linkedNetwork.topologyCache.misses, linkedNetwork.topologyCache.getHitRate());
+    }
+    if (linkedNetwork.reuseProposalOutcomes) {
+        logger->info("Number of repeated proposals reused: {}", linkedNetwork.numReusedProposals);
+    }
+    if (linkedNetwork.numTopologyOnlySwitches > 0) {
+        logger->info("Number of topology-only switches: {}", linkedNetwork.numTopologyOnlySwitches);
+    }
+    if (linkedNetwork.relaxationTemplates.isEnabled) {
+        logger->info("Mean minimiser iterations with relaxation template: {:.1f} ({} minimisations) without: {:.1f} ({} minimisations)",
+                     linkedNetwork.relaxationTemplates.getMeanIterations(true), linkedNetwork.relaxationTemplates.numWithTemplate,
+                     linkedNetwork.relaxationTemplates.getMeanIterations(false), linkedNetwork.relaxationTemplates.numWithoutTemplate);
+    }
+    if (linkedNetwork.pipelineProposals) {
+        logger->info("Number of prepared proposals discarded: {}", linkedNetwork.numDiscardedProposals);
+    }
+    if (linkedNetwork.numBatchRelaxations > 0) {
+        logger->info("Mean switches per relaxation: {:.2f} ({} relaxations)",
+                     (double)(linkedNetwork.numSwitches - linkedNetwork.numTopologyOnlySwitches) / linkedNetwork.numBatchRelaxations,
+                     linkedNetwork.numBatchRelaxations);
+    }
+    linkedNetwork.logMemoryUsage();
+    logger->info("Network consistent: {}", networkConsistent ? "true" : "false");
+    logger->info("");
+    writeStatsFooter(linkedNetwork, allStatsFile, networkConsistent, start);
+    writeStageEquilibrations(stageEquilibrations, "./output_files");
+
+    // Log time taken
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start) / 1000.0;
+    logger->info("Total run time: {:.3f} s", duration.count());
+    logger->info("Average time per step: {:.3f} us", duration.count() / linkedNetwork.numSwitches * 1000.0);
+    std::filesystem::remove("./log.lammps");
+    if (exitFlag) {
+        throw JobInterrupted("Interrupted by SIGINT, the network so far has been written");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Set up signal handler to cleanly exit when we use Cntrl + C
+    signal(SIGINT, exitFlagger);
+
+    // Check command line arguments for the --debug flag, and the spool folder and workers of server mode
+    bool isDebug = false;
+    std::string spoolDirectory;
+    int numWorkers = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "ds:w:")) != -1) {
+        if (opt == 'd') {
+            isDebug = true;
+        } else if (opt == 's') {
+            spoolDirectory = optarg;
+        } else if (opt == 'w') {
+            numWorkers = std::atoi(optarg);
         }
+    }
+    LoggerPtr logger;
+    try {
+        std::string logPath = spoolDirectory.empty() ? std::filesystem::path("./output_files") / "bond_switch_simulator.log"
+                                                     : std::filesystem::path(spoolDirectory) / "job_server.log";
+        logger = initialiseLogger(logPath, isDebug);
+    } catch (std::exception &e) {
+        std::cerr << "Exception while initialising logger: " << e.what() << std::endl;
+        return 1;
+    }
+    try {
+        logger->info("Bond Switch Simulator");
+        logger->info("Written by Marshall Hunt (Part II), Wilson Group, 2024");
 
-        logger->info("Annealing...");
-        runSimulation(annealingTemperatures, linkedNetwork, allStatsFile, inputData.analysisWriteInterval, logger);
-        logger->info("Simulation complete!");
-        linkedNetwork.lammpsNetwork.stopMovie();
-
-        logger->debug("Writing final network files...");
-        linkedNetwork.write();
-        linkedNetwork.lammpsNetwork.writeData();
-        bool networkConsistent = linkedNetwork.checkConsistency();
-        logger->info("");
-        logger->info("Number of attempted switches: {}", linkedNetwork.numSwitches);
-        logger->info("Number of accepted switches: {}", linkedNetwork.numAcceptedSwitches);
-        logger->info("Number of failed switches due to angle: {}", linkedNetwork.failedAngleChecks);
-        logger->info("Number of failed switches due to bond length: {}", linkedNetwork.failedBondLengthChecks);
-        logger->info("Number of failed switches due to energy: {}", linkedNetwork.failedEnergyChecks);
-        logger->info("");
-        logger->info("Monte Carlo acceptance: {:.3f}", (double)linkedNetwork.numAcceptedSwitches / linkedNetwork.numSwitches);
-        logger->info("Network consistent: {}", networkConsistent ? "true" : "false");
-        logger->info("");
-        writeStatsFooter(linkedNetwork, allStatsFile, networkConsistent);
-
-        // Log time taken
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start) / 1000.0;
-        logger->info("Total run time: {:.3f} s", duration.count());
-        logger->info("Average time per step: {:.3f} us", duration.count() / linkedNetwork.numSwitches * 1000.0);
-        std::filesystem::remove("./log.lammps");
+        if (!spoolDirectory.empty()) {
+            JobServer server(spoolDirectory, numWorkers, runJob, logger);
+            server.run(exitFlag);
+        } else {
+            // Read input file
+            InputData inputData(std::filesystem::path("./input_files") /"bss_parameters.txt", logger);
+            runJob(inputData, logger);
+        }
         logger->flush();
         spdlog::shutdown();
 
 
+    } catch (JobInterrupted &e) {
+        logger->warn("{}", e.what());
+        logger->flush();
+        spdlog::shutdown();
+        return 0;
     } catch (std::exception &e) {
         logger->error("Exception: {}", e.what());
         logger->flush();
@@ -0,0 +1,70 @@
+#include "mapped_array.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+/**
+ * @brief Default constructor for an empty array
+ */
+MappedArray::MappedArray() = default;
+
+/**
+ * @brief Create a zero initialised array backed by an unlinked temporary file in a directory.
+ * The file is removed straight away, so it disappears when the array is destroyed or the program exits.
+ * @param directory Directory to create the backing file in
+ * @param sizeArg Number of floats in the array
+ * @throw std::runtime_error if the backing file cannot be created or mapped
+ */
+MappedArray::MappedArray(const std::string &directory, const size_t &sizeArg) : size(sizeArg) {
+    if (size == 0) {
+        return;
+    }
+    std::string filePath = (std::filesystem::path(directory) / "mapped_array_XXXXXX").string();
+    int fileDescriptor = mkstemp(filePath.data());
+    if (fileDescriptor == -1) {
+        throw std::runtime_error("Unable to create memory mapped file in: " + directory);
+    }
+    unlink(filePath.c_str());
+    if (ftruncate(fileDescriptor, static_cast<off_t>(getNumBytes())) != 0) {
+        close(fileDescriptor);
+        throw std::runtime_error("Unable to resize memory mapped file: " + filePath);
+    }
+    void *mapping = mmap(nullptr, getNumBytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    close(fileDescriptor);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Unable to memory map file: " + filePath);
+    }
+    data = static_cast<float *>(mapping);
+}
+
+MappedArray::MappedArray(MappedArray &&other) noexcept : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {
+}
+
+MappedArray &MappedArray::operator=(MappedArray &&other) noexcept {
+    if (this != &other) {
+        if (data != nullptr) {
+            munmap(data, getNumBytes());
+        }
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+MappedArray::~MappedArray() {
+    if (data != nullptr) {
+        munmap(data, getNumBytes());
+    }
+}
+
+/**
+ * @brief Get the size of the array in bytes
+ * @return Number of bytes mapped
+ */
+size_t MappedArray::getNumBytes() const {
+    return size * sizeof(float);
+}
@@ -18,9 +18,11 @@ Metropolis::Metropolis(const int &seed) {
  * @param finalEnergy Final energy
  * @param initialEnergy Initial energy
  * @param temperature Temperature factor
- * @return True if final energy less than initial, or with probability e^(-deltaE/T)
+ * @param proposalRatio Probability of proposing the reverse move over the probability of proposing the move, 1 for symmetric proposals
+ * @return True if final energy less than initial, or with probability min(1, proposalRatio * e^(-deltaE/T))
  */
-bool Metropolis::acceptanceCriterion(const double &finalEnergy, const double &initialEnergy, const double &temperature) {
-    const double energyChange = finalEnergy - initialEnergy;
+bool Metropolis::acceptanceCriterion(const double &finalEnergy, const double &initialEnergy, const double &temperature,
+                                     const double &proposalRatio) {
+    const double energyChange = finalEnergy - initialEnergy - temperature * std::log(proposalRatio);
     return energyChange < 0 || randNumDist(randomNumGen) < exp(-energyChange / temperature);
 }
\ No newline at end of file
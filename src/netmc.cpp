@@ -0,0 +1,206 @@
+// C interface to LinkedNetwork, see netmc.h
+#include "netmc.h"
+#include "linked_network.h"
+#include <cstring>
+#include <spdlog/sinks/null_sink.h>
+
+struct netmc_simulation {
+    LoggerPtr logger;
+    std::unique_ptr<LinkedNetwork> linkedNetwork;
+    mutable std::string error; // Set by failed getters too
+};
+
+namespace {
+/**
+ * @brief Call a function, turning any exception into a return value so none cross the C interface
+ * @param simulation The simulation to record the error in
+ * @param function The function to call
+ * @return 0 if the function returned, -1 if it threw or simulation is null
+ */
+template <typename Function>
+int callSafely(const netmc_simulation *simulation, Function function) {
+    if (simulation == nullptr) {
+        return -1;
+    }
+    try {
+        function();
+        simulation->error.clear();
+        return 0;
+    } catch (const std::exception &e) {
+        simulation->error = e.what();
+    } catch (...) {
+        simulation->error = "Unknown exception";
+    }
+    return -1;
+}
+
+/**
+ * @brief Check that an output array is big enough
+ * @param array The array given
+ * @param size The size of the array given
+ * @param required The size of the array needed
+ * @throw std::invalid_argument if the array is null or too small
+ */
+void checkSize(const void *array, const int &size, const size_t &required) {
+    if (array == nullptr) {
+        throw std::invalid_argument("Null array given");
+    }
+    if (size < 0 || static_cast<size_t>(size) < required) {
+        throw std::invalid_argument("Array of size " + std::to_string(size) + " is too small, " + std::to_string(required) + " values are needed");
+    }
+}
+} // namespace
+
+int netmc_abi_version(void) {
+    return NETMC_ABI_VERSION;
+}
+
+netmc_simulation *netmc_create(const char *parameters, int num_nodes, const double *coords,
+                               const int *connection_offsets, const int *connections, double xhi, double yhi,
+                               const char *potential, char *error, int error_size) {
+    std::unique_ptr<netmc_simulation> simulation;
+    try {
+        simulation = std::make_unique<netmc_simulation>();
+        // Each simulation has its own unregistered logger, so any number can exist at once
+        simulation->logger = std::make_shared<spdlog::logger>("netmc", std::make_shared<spdlog::sinks::null_sink_mt>());
+    } catch (...) {
+        if (error != nullptr && error_size > 0) {
+            std::strncpy(error, "Failed to allocate the simulation", error_size - 1);
+            error[error_size - 1] = '\0';
+        }
+        return nullptr;
+    }
+    int result = callSafely(simulation.get(), [&]() {
+        if (parameters == nullptr || coords == nullptr || connection_offsets == nullptr || connections == nullptr || potential == nullptr) {
+            throw std::invalid_argument("Null argument given to netmc_create");
+        }
+        std::vector<std::vector<int>> nodeConnections(num_nodes);
+        for (int i = 0; i < num_nodes; ++i) {
+            nodeConnections[i].assign(connections + connection_offsets[i], connections + connection_offsets[i + 1]);
+        }
+        Network baseNetwork(std::vector<double>(coords, coords + 2 * num_nodes), nodeConnections, {xhi, yhi});
+        std::istringstream parameterStream(parameters);
+        InputData inputData(parameterStream, simulation->logger);
+        simulation->linkedNetwork = std::make_unique<LinkedNetwork>(inputData, &baseNetwork, potential, simulation->logger);
+    });
+    if (result != 0) {
+        if (error != nullptr && error_size > 0) {
+            std::strncpy(error, simulation->error.c_str(), error_size - 1);
+            error[error_size - 1] = '\0';
+        }
+        if (simulation->linkedNetwork) {
+            simulation->linkedNetwork->lammpsNetwork.close();
+        }
+        return nullptr;
+    }
+    return simulation.release();
+}
+
+void netmc_destroy(netmc_simulation *simulation) {
+    if (simulation == nullptr) {
+        return;
+    }
+    if (simulation->linkedNetwork) {
+        simulation->linkedNetwork->lammpsNetwork.close();
+    }
+    delete simulation;
+}
+
+int netmc_run(netmc_simulation *simulation, int num_steps, double temperature) {
+    return callSafely(simulation, [&]() {
+        for (int i = 0; i < num_steps; ++i) {
+            simulation->linkedNetwork->monteCarloSwitchMoveLAMMPS(temperature);
+        }
+        // Topology-only switches leave LAMMPS behind, and the energy with it
+        simulation->linkedNetwork->syncLammpsNetwork();
+    });
+}
+
+int netmc_get_num_nodes(const netmc_simulation *simulation) {
+    int numNodes = -1;
+    callSafely(simulation, [&]() { numNodes = static_cast<int>(simulation->linkedNetwork->networkA.nodes.size()); });
+    return numNodes;
+}
+
+int netmc_get_num_rings(const netmc_simulation *simulation) {
+    int numRings = -1;
+    callSafely(simulation, [&]() { numRings = static_cast<int>(simulation->linkedNetwork->networkB.nodes.size()); });
+    return numRings;
+}
+
+int netmc_get_statistics(netmc_simulation *simulation, netmc_statistics *statistics) {
+    return callSafely(simulation, [&]() {
+        if (statistics == nullptr) {
+            throw std::invalid_argument("Null statistics given");
+        }
+        LinkedNetwork &linkedNetwork = *simulation->linkedNetwork;
+        linkedNetwork.networkB.refreshStatistics();
+        statistics->num_switches = linkedNetwork.numSwitches;
+        statistics->num_accepted_switches = linkedNetwork.numAcceptedSwitches;
+        statistics->failed_angle_checks = linkedNetwork.failedAngleChecks;
+        statistics->failed_bond_length_checks = linkedNetwork.failedBondLengthChecks;
+        statistics->failed_energy_checks = linkedNetwork.failedEnergyChecks;
+        statistics->energy = linkedNetwork.energy;
+        statistics->entropy = linkedNetwork.networkB.entropy;
+        statistics->pearsons_coeff = linkedNetwork.networkB.pearsonsCoeff;
+        statistics->aboav_weaire = linkedNetwork.networkB.getAboavWeaire();
+        statistics->mean_ring_size = linkedNetwork.networkB.getAverageCoordination();
+    });
+}
+
+int netmc_get_coords(const netmc_simulation *simulation, double *coords, int size) {
+    return callSafely(simulation, [&]() {
+        Network baseNetwork;
+        Network ringNetwork;
+        simulation->linkedNetwork->getOriginalNetworks(baseNetwork, ringNetwork);
+        checkSize(coords, size, 2 * baseNetwork.nodes.size());
+        for (size_t i = 0; i < baseNetwork.nodes.size(); ++i) {
+            coords[2 * i] = baseNetwork.nodes[i].crd[0];
+            coords[2 * i + 1] = baseNetwork.nodes[i].crd[1];
+        }
+    });
+}
+
+int netmc_get_connections(const netmc_simulation *simulation, int *connection_offsets, int *connections, int size) {
+    return callSafely(simulation, [&]() {
+        Network baseNetwork;
+        Network ringNetwork;
+        simulation->linkedNetwork->getOriginalNetworks(baseNetwork, ringNetwork);
+        const std::vector<Node> &nodes = baseNetwork.nodes;
+        size_t numConnections = 0;
+        for (const Node &node : nodes) {
+            numConnections += node.netConnections.size();
+        }
+        if (connection_offsets == nullptr) {
+            throw std::invalid_argument("Null connection offsets given");
+        }
+        checkSize(connections, size, numConnections);
+        int offset = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            connection_offsets[i] = offset;
+            std::copy(nodes[i].netConnections.begin(), nodes[i].netConnections.end(), connections + offset);
+            offset += static_cast<int>(nodes[i].netConnections.size());
+        }
+        connection_offsets[nodes.size()] = offset;
+    });
+}
+
+int netmc_get_ring_sizes(const netmc_simulation *simulation, int *ring_sizes, int size) {
+    return callSafely(simulation, [&]() {
+        Network baseNetwork;
+        Network ringNetwork;
+        simulation->linkedNetwork->getOriginalNetworks(baseNetwork, ringNetwork);
+        const std::vector<Node> &rings = ringNetwork.nodes;
+        checkSize(ring_sizes, size, rings.size());
+        for (size_t i = 0; i < rings.size(); ++i) {
+            ring_sizes[i] = static_cast<int>(rings[i].netConnections.size());
+        }
+    });
+}
+
+const char *netmc_get_error(const netmc_simulation *simulation) {
+    if (simulation == nullptr) {
+        return "Null simulation given";
+    }
+    return simulation->error.c_str();
+}
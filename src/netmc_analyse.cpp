@@ -0,0 +1,226 @@
+// Standalone analysis of the networks written by many bond switch simulator runs
+#include "network.h"
+#include "output_file.h"
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "spdlog/spdlog.h"
+#include <filesystem>
+#include <omp.h>
+#include <set>
+#include <unistd.h>
+
+struct RunAnalysis {
+    std::string directory;
+    bool isLoaded = false;
+    std::map<int, double> ringSizes; // Fraction of rings of each size
+    std::vector<double> values;      // One value per column in VALUE_HEADERS
+};
+
+const std::vector<std::string> VALUE_HEADERS = {
+    "Nodes", "Rings", "Mean Ring Size", "Entropy", "Pearson's Coefficient", "Aboav Weaire",
+    "Mean Ring Area", "Ring Area SD", "Mean Bond Length", "Bond Length SD", "Mean Bond Angle (deg)", "Bond Angle SD (deg)"};
+
+/**
+ * @brief Get the mean and population standard deviation of a vector
+ * @param vector The vector to be summarised
+ * @return A pair of the mean and standard deviation, both 0 if the vector is empty
+ */
+std::pair<double, double> getMeanAndDeviation(const std::vector<double> &vector) {
+    if (vector.empty()) {
+        return {0.0, 0.0};
+    }
+    double mean = vectorMean(vector);
+    double sumSquares = 0.0;
+    for (const double &value : vector) {
+        sumSquares += (value - mean) * (value - mean);
+    }
+    return {mean, std::sqrt(sumSquares / vector.size())};
+}
+
+/**
+ * @brief Check if a directory holds the network files written by Network::write
+ * @param directory The directory to check
+ * @return true if the base network info file is in the directory, false otherwise
+ */
+bool isNetworkDirectory(const std::filesystem::path &directory) {
+    return std::filesystem::exists(directory / "base_network_info.txt");
+}
+
+/**
+ * @brief Find the network directories in a path, which may be a network directory, a run folder
+ * containing output_files, or a sweep folder with one run per subdirectory
+ * @param path The path given on the command line
+ * @param logger The logger to log to
+ * @return Vector of network directories, in alphabetical order for sweep folders
+ */
+std::vector<std::filesystem::path> findNetworkDirectories(const std::filesystem::path &path, const LoggerPtr &logger) {
+    if (isNetworkDirectory(path)) {
+        return {path};
+    }
+    if (isNetworkDirectory(path / "output_files")) {
+        return {path / "output_files"};
+    }
+    std::vector<std::filesystem::path> directories;
+    if (std::filesystem::is_directory(path)) {
+        for (const auto &entry : std::filesystem::directory_iterator(path)) {
+            if (isNetworkDirectory(entry.path())) {
+                directories.push_back(entry.path());
+            } else if (isNetworkDirectory(entry.path() / "output_files")) {
+                directories.push_back(entry.path() / "output_files");
+            }
+        }
+        std::sort(directories.begin(), directories.end());
+    }
+    if (directories.empty()) {
+        logger->warn("No networks found in: {}", path.string());
+    }
+    return directories;
+}
+
+/**
+ * @brief Load the base and ring networks in a directory and compute their statistics
+ * @param directory Directory containing the network files
+ * @param logger The logger to log to
+ * @return The statistics of the run
+ * @throw std::runtime_error if any of the network files cannot be opened
+ */
+RunAnalysis analyseDirectory(const std::filesystem::path &directory, const LoggerPtr &logger) {
+    Network baseNetwork(directory.string(), NetworkType::BASE_NETWORK, true, logger);
+    Network ringNetwork(directory.string(), NetworkType::DUAL_NETWORK, true, logger);
+    ringNetwork.refreshStatistics();
+
+    RunAnalysis analysis;
+    analysis.directory = directory.string();
+    analysis.isLoaded = true;
+    analysis.ringSizes = ringNetwork.nodeSizes;
+
+    auto [meanRingArea, ringAreaDeviation] = getMeanAndDeviation(ringNetwork.getRingAreas(baseNetwork));
+    auto [meanBondLength, bondLengthDeviation] = getMeanAndDeviation(baseNetwork.getBondLengths());
+    std::vector<double> bondAngles = baseNetwork.getBondAngles();
+    vectorMultiply(bondAngles, 180 / M_PI);
+    auto [meanBondAngle, bondAngleDeviation] = getMeanAndDeviation(bondAngles);
+
+    analysis.values = {static_cast<double>(baseNetwork.nodes.size()), static_cast<double>(ringNetwork.nodes.size()),
+                       ringNetwork.getAverageCoordination(), ringNetwork.entropy, ringNetwork.pearsonsCoeff,
+                       ringNetwork.getAboavWeaire(), meanRingArea, ringAreaDeviation, meanBondLength,
+                       bondLengthDeviation, meanBondAngle, bondAngleDeviation};
+    return analysis;
+}
+
+/**
+ * @brief Write one row per run and a final row of the mean over all runs
+ * @param analyses The statistics of every run, in the order they were given
+ * @param outputPath Path of the CSV file to write
+ * @throw std::runtime_error if the output file cannot be opened
+ */
+void writeTable(const std::vector<RunAnalysis> &analyses, const std::string &outputPath) {
+    std::set<int> ringSizes;
+    std::vector<double> meanValues(VALUE_HEADERS.size(), 0.0);
+    std::map<int, double> meanRingSizes;
+    int numLoaded = 0;
+    for (const RunAnalysis &analysis : analyses) {
+        if (!analysis.isLoaded) {
+            continue;
+        }
+        numLoaded++;
+        for (size_t i = 0; i < meanValues.size(); ++i) {
+            meanValues[i] += analysis.values[i];
+        }
+        for (const auto &[ringSize, fraction] : analysis.ringSizes) {
+            ringSizes.insert(ringSize);
+            meanRingSizes[ringSize] += fraction;
+        }
+    }
+
+    OutputFile table(outputPath);
+    std::ostringstream header;
+    header << "Directory";
+    for (const std::string &valueHeader : VALUE_HEADERS) {
+        header << ", " << valueHeader;
+    }
+    for (const int &ringSize : ringSizes) {
+        header << ", P(" << ringSize << ")";
+    }
+    table.writeLine(header.str());
+
+    auto writeRow = [&table, &ringSizes](const std::string &name, const std::vector<double> &values, const std::map<int, double> &fractions) {
+        std::ostringstream row;
+        row << name;
+        for (const double &value : values) {
+            row << "," << value;
+        }
+        for (const int &ringSize : ringSizes) {
+            auto it = fractions.find(ringSize);
+            row << "," << (it == fractions.end() ? 0.0 : it->second);
+        }
+        table.writeLine(row.str());
+    };
+    for (const RunAnalysis &analysis : analyses) {
+        if (analysis.isLoaded) {
+            writeRow(analysis.directory, analysis.values, analysis.ringSizes);
+        }
+    }
+    if (numLoaded > 0) {
+        vectorDivide(meanValues, numLoaded);
+        for (auto &[ringSize, fraction] : meanRingSizes) {
+            fraction /= numLoaded;
+        }
+        writeRow("Mean", meanValues, meanRingSizes);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    auto logger = spdlog::stdout_color_mt("netmc_analyse");
+    logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+    logger->set_level(spdlog::level::info);
+
+    std::string outputPath = "netmc_analysis.csv";
+    int opt;
+    while ((opt = getopt(argc, argv, "o:j:d")) != -1) {
+        switch (opt) {
+        case 'o':
+            outputPath = optarg;
+            break;
+        case 'j':
+            omp_set_num_threads(std::stoi(optarg));
+            break;
+        case 'd':
+            logger->set_level(spdlog::level::debug);
+            break;
+        default:
+            std::cerr << "Usage: " << argv[0] << " [-o output.csv] [-j threads] [-d] directory..." << std::endl;
+            return 1;
+        }
+    }
+    if (optind >= argc) {
+        std::cerr << "Usage: " << argv[0] << " [-o output.csv] [-j threads] [-d] directory..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> directories;
+    for (int i = optind; i < argc; ++i) {
+        std::vector<std::filesystem::path> found = findNetworkDirectories(argv[i], logger);
+        directories.insert(directories.end(), found.begin(), found.end());
+    }
+    logger->info("Analysing {} networks on {} threads", directories.size(), omp_get_max_threads());
+
+    std::vector<RunAnalysis> analyses(directories.size());
+    int numFailed = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : numFailed)
+    for (int i = 0; i < static_cast<int>(directories.size()); ++i) {
+        try {
+            analyses[i] = analyseDirectory(directories[i], logger);
+        } catch (const std::exception &e) {
+            logger->warn("Skipping {}: {}", directories[i].string(), e.what());
+            numFailed++;
+        }
+    }
+
+    try {
+        writeTable(analyses, outputPath);
+    } catch (const std::exception &e) {
+        logger->error("Exception while writing table: {}", e.what());
+        return 1;
+    }
+    logger->info("Wrote {} networks to {}, {} skipped", directories.size() - numFailed, outputPath, numFailed);
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "network.h"
+#include <cstdint>
 #include <filesystem>
 
 const std::string BSS_NETWORK_PATH = std::filesystem::path("./input_files") / "bss_network";
@@ -53,27 +54,64 @@ Network::Network() = default;
 
 
 /**
- * @brief Construct a network from files
+ * @brief Construct a network from the input files
  * @param networkString networkString of files to load
  * @param maxBaseCoordinationArg Maximum base coordination of nodes
  * @param maxDualCoordinationArg Maximum dual coordination of nodes
  * @param logger Logger to log to
  * @throw std::runtime_error if cannot open info file, crds file, net file or dual file
  */
-Network::Network(const NetworkType networkType, const LoggerPtr &logger) : type(networkType), networkString(NetworkTypeToString(networkType)) {
+Network::Network(const NetworkType networkType, const LoggerPtr &logger) : Network(BSS_NETWORK_PATH, networkType, true, logger) {
+}
+
+/**
+ * @brief Construct a network from files in a given directory, such as the output folder of a previous run
+ * @param directory Directory containing the info, coords, connections and dual connections files
+ * @param networkType Type of network to load
+ * @param readDualConnections Read the dual connections file, false if they will be derived instead
+ * @param logger Logger to log to
+ * @throw std::runtime_error if cannot open info file, crds file, net file or dual file
+ */
+Network::Network(const std::string &directory, const NetworkType networkType, const bool &readDualConnections, const LoggerPtr &logger) : type(networkType), networkString(NetworkTypeToString(networkType)) {
     logger->debug("Reading file: " + networkString + "_info.txt");
-    readInfo(std::filesystem::path(BSS_NETWORK_PATH) / (networkString + "_info.txt"));
+    readInfo(std::filesystem::path(directory) / (networkString + "_info.txt"));
     nodes.reserve(numNodes);
     for (int i = 0; i < numNodes; ++i) {
         Node node(i);
         nodes.push_back(node);
     }
     logger->debug("Reading file: " + networkString + "_coords.txt");
-    readCoords(std::filesystem::path(BSS_NETWORK_PATH) / (networkString + "_coords.txt"));
+    readCoords(std::filesystem::path(directory) / (networkString + "_coords.txt"));
     logger->debug("Reading file: " + networkString + "_connections.txt");
-    readConnections(std::filesystem::path(BSS_NETWORK_PATH) / (networkString + "_connections.txt"), false);
-    logger->debug("Reading file: " + networkString + "_dual_connections.txt");
-    readConnections(std::filesystem::path(BSS_NETWORK_PATH) / (networkString + "_dual_connections.txt"), true);
+    readConnections(std::filesystem::path(directory) / (networkString + "_connections.txt"), false);
+    if (readDualConnections) {
+        logger->debug("Reading file: " + networkString + "_dual_connections.txt");
+        readConnections(std::filesystem::path(directory) / (networkString + "_dual_connections.txt"), true);
+    }
+}
+
+/**
+ * @brief Construct a base network from coordinates and connections in memory, without dual connections
+ * @param coords Coordinates of the nodes as a 1D vector of pairs
+ * @param connections IDs of the neighbours of each node
+ * @param dimensionsArg Periodic boundary of the network, [xhi, yhi]
+ * @throw std::invalid_argument if the sizes do not match or a connection is not to another node
+ */
+Network::Network(const std::vector<double> &coords, const std::vector<std::vector<int>> &connections, const std::vector<double> &dimensionsArg)
+    : type(NetworkType::BASE_NETWORK), networkString(NetworkTypeToString(NetworkType::BASE_NETWORK)), dimensions(dimensionsArg) {
+    numNodes = static_cast<int>(connections.size());
+    if (coords.size() != 2 * connections.size() || dimensions.size() != 2) {
+        throw std::invalid_argument("Number of coordinates does not match number of nodes");
+    }
+    nodes.reserve(numNodes);
+    for (int i = 0; i < numNodes; ++i) {
+        for (const int &cnx : connections[i]) {
+            if (cnx < 0 || cnx >= numNodes || cnx == i) {
+                throw std::invalid_argument("Invalid connection from node " + std::to_string(i) + " to " + std::to_string(cnx));
+            }
+        }
+        nodes.emplace_back(i, std::vector<double>{coords[2 * i], coords[2 * i + 1]}, connections[i], std::vector<int>());
+    }
 }
 
 
@@ -152,33 +190,272 @@ int Network::findNumberOfUniqueDualNodes() {
  * @param baseNetwork Base network to provide dual node IDs
  */
 void Network::centreRings(const Network &baseNetwork) {
-    std::vector<double> total(2, 0.0);
     for (int ringNode = 0; ringNode < nodes.size(); ++ringNode) {
-        Node &selectedRingNode = nodes[ringNode];
-        total[0] = total[1] = 0.0;
-        for (int neighbour = 0; neighbour < selectedRingNode.dualConnections.size(); ++neighbour) {
-            std::vector<double> pbcCoords = pbcVector(selectedRingNode.crd,
-                                                      baseNetwork.nodes[selectedRingNode.dualConnections[neighbour]].crd,
-                                                      dimensions);
-            total[0] += pbcCoords[0];
-            total[1] += pbcCoords[1];
+        centreRing(ringNode, baseNetwork);
+    }
+}
+
+/**
+ * @brief Centre a single node relative to its dual connections
+ * @param ringNode ID of the node to centre
+ * @param baseNetwork Base network to provide dual node IDs
+ */
+void Network::centreRing(const int &ringNode, const Network &baseNetwork) {
+    std::vector<double> total(2, 0.0);
+    Node &selectedRingNode = nodes[ringNode];
+    for (int neighbour = 0; neighbour < selectedRingNode.dualConnections.size(); ++neighbour) {
+        std::vector<double> pbcCoords = pbcVector(selectedRingNode.crd,
+                                                  baseNetwork.nodes[selectedRingNode.dualConnections[neighbour]].crd,
+                                                  dimensions);
+        total[0] += pbcCoords[0];
+        total[1] += pbcCoords[1];
+    }
+    total[0] /= selectedRingNode.dualConnections.size();
+    total[1] /= selectedRingNode.dualConnections.size();
+
+    selectedRingNode.crd[0] += total[0];
+    selectedRingNode.crd[1] += total[1];
+
+    // Wrap the new coordinates back into the box
+    for (size_t i = 0; i < selectedRingNode.crd.size(); ++i) {
+        while (selectedRingNode.crd[i] < 0) {
+            selectedRingNode.crd[i] += dimensions[i];
         }
-        total[0] /= selectedRingNode.dualConnections.size();
-        total[1] /= selectedRingNode.dualConnections.size();
+        while (selectedRingNode.crd[i] >= dimensions[i]) {
+            selectedRingNode.crd[i] -= dimensions[i];
+        }
+    }
+}
 
-        selectedRingNode.crd[0] += total[0];
-        selectedRingNode.crd[1] += total[1];
+/**
+ * @brief Build the ring network of this base network by walking the faces of the periodic planar graph.
+ * Every node's connections are sorted clockwise, so each directed bond u -> v is followed around its ring by
+ * v -> w, where w is the neighbour after u in v's clockwise order. Each directed bond lies in exactly one ring.
+ * The dual connections of this network are overwritten with the rings around each node.
+ * @return The ring network, with rings numbered in order of their lowest directed bond
+ * @throw std::runtime_error if a connection is not reciprocated or the rings do not tile a periodic plane
+ */
+Network Network::deriveRingNetwork() {
+    int numBaseNodes = nodes.size();
+#pragma omp parallel for
+    for (int nodeID = 0; nodeID < numBaseNodes; ++nodeID) {
+        Node &node = nodes[nodeID];
+        std::vector<std::pair<double, int>> angles;
+        angles.reserve(node.netConnections.size());
+        for (const int &cnx : node.netConnections) {
+            angles.emplace_back(getClockwiseAngle(node.crd, nodes[cnx].crd, dimensions), cnx);
+        }
+        std::sort(angles.begin(), angles.end());
+        for (size_t i = 0; i < angles.size(); ++i) {
+            node.netConnections[i] = angles[i].second;
+        }
+    }
+
+    // Directed bonds are numbered so the bonds leaving a node are contiguous and in clockwise order
+    std::vector<int> bondOffsets(numBaseNodes + 1, 0);
+    for (int nodeID = 0; nodeID < numBaseNodes; ++nodeID) {
+        bondOffsets[nodeID + 1] = bondOffsets[nodeID] + nodes[nodeID].netConnections.size();
+    }
+    int numBonds = bondOffsets.back();
+    std::vector<int> bondSources(numBonds);
+    std::vector<int> reverseBonds(numBonds);
+    std::vector<int> nextBonds(numBonds);
+    bool isReciprocated = true;
+#pragma omp parallel for reduction(&& : isReciprocated)
+    for (int nodeID = 0; nodeID < numBaseNodes; ++nodeID) {
+        for (size_t i = 0; i < nodes[nodeID].netConnections.size(); ++i) {
+            int bond = bondOffsets[nodeID] + i;
+            int cnx = nodes[nodeID].netConnections[i];
+            const std::vector<int> &cnxConnections = nodes[cnx].netConnections;
+            auto it = std::find(cnxConnections.begin(), cnxConnections.end(), nodeID);
+            if (it == cnxConnections.end()) {
+                isReciprocated = false;
+                continue;
+            }
+            int reverseIndex = it - cnxConnections.begin();
+            bondSources[bond] = nodeID;
+            reverseBonds[bond] = bondOffsets[cnx] + reverseIndex;
+            nextBonds[bond] = bondOffsets[cnx] + (reverseIndex + 1) % cnxConnections.size();
+        }
+    }
+    if (!isReciprocated) {
+        throw std::runtime_error("Cannot derive ring network, base network connections are not reciprocated");
+    }
+
+    // A ring is owned by its lowest numbered bond, so rings can be found in parallel without claiming bonds
+    std::vector<char> isRingStart(numBonds, 0);
+#pragma omp parallel for schedule(static, 1024)
+    for (int bond = 0; bond < numBonds; ++bond) {
+        int ringBond = nextBonds[bond];
+        while (ringBond > bond) {
+            ringBond = nextBonds[ringBond];
+        }
+        isRingStart[bond] = (ringBond == bond);
+    }
+    std::vector<int> ringStarts;
+    for (int bond = 0; bond < numBonds; ++bond) {
+        if (isRingStart[bond]) {
+            ringStarts.push_back(bond);
+        }
+    }
+    int numRings = ringStarts.size();
+    // Euler characteristic of a torus, V - E + F = 0
+    if (numRings != numBonds / 2 - numBaseNodes) {
+        std::ostringstream oss;
+        oss << "Cannot derive ring network, found " << numRings << " rings but a periodic network with " << numBaseNodes
+            << " nodes and " << numBonds / 2 << " bonds must have " << numBonds / 2 - numBaseNodes;
+        throw std::runtime_error(oss.str());
+    }
 
-        // Wrap the new coordinates back into the box
-        for (size_t i = 0; i < selectedRingNode.crd.size(); ++i) {
-            while (selectedRingNode.crd[i] < 0) {
-                selectedRingNode.crd[i] += dimensions[i];
+    Network ringNetwork;
+    ringNetwork.type = NetworkType::DUAL_NETWORK;
+    ringNetwork.networkString = NetworkTypeToString(NetworkType::DUAL_NETWORK);
+    ringNetwork.numNodes = numRings;
+    ringNetwork.dimensions = dimensions;
+    ringNetwork.nodes.resize(numRings);
+    std::vector<int> bondRings(numBonds);
+#pragma omp parallel for
+    for (int ringID = 0; ringID < numRings; ++ringID) {
+        Node &ring = ringNetwork.nodes[ringID];
+        ring.id = ringID;
+        ring.crd = nodes[bondSources[ringStarts[ringID]]].crd;
+        int bond = ringStarts[ringID];
+        do {
+            bondRings[bond] = ringID;
+            ring.dualConnections.push_back(bondSources[bond]);
+            bond = nextBonds[bond];
+        } while (bond != ringStarts[ringID]);
+    }
+#pragma omp parallel for
+    for (int ringID = 0; ringID < numRings; ++ringID) {
+        Node &ring = ringNetwork.nodes[ringID];
+        int bond = ringStarts[ringID];
+        do {
+            int neighbourRing = bondRings[reverseBonds[bond]];
+            if (neighbourRing != ringID && !vectorContains(ring.netConnections, neighbourRing)) {
+                ring.netConnections.push_back(neighbourRing);
             }
-            while (selectedRingNode.crd[i] >= dimensions[i]) {
-                selectedRingNode.crd[i] -= dimensions[i];
+            bond = nextBonds[bond];
+        } while (bond != ringStarts[ringID]);
+    }
+#pragma omp parallel for
+    for (int nodeID = 0; nodeID < numBaseNodes; ++nodeID) {
+        nodes[nodeID].dualConnections.clear();
+        for (int bond = bondOffsets[nodeID]; bond < bondOffsets[nodeID + 1]; ++bond) {
+            nodes[nodeID].dualConnections.push_back(bondRings[bond]);
+        }
+    }
+    ringNetwork.centreRings(*this);
+    return ringNetwork;
+}
+
+/**
+ * @brief Get the order of the nodes along a Hilbert curve through the periodic box, so that nodes close in
+ * space get close IDs
+ * @return Vector where order[newID] is the current ID of the node given newID
+ */
+std::vector<int> Network::getHilbertOrder() const {
+    // Hilbert index of each node on a 2^16 x 2^16 grid over the box
+    const uint32_t gridSize = 1 << 16;
+    std::vector<uint64_t> curveIndices(nodes.size());
+    for (int nodeID = 0; nodeID < nodes.size(); ++nodeID) {
+        uint32_t cell[2];
+        for (int dim = 0; dim < 2; ++dim) {
+            double fraction = nodes[nodeID].crd[dim] / dimensions[dim];
+            fraction -= std::floor(fraction);
+            cell[dim] = std::min(static_cast<uint32_t>(fraction * gridSize), gridSize - 1);
+        }
+        uint64_t curveIndex = 0;
+        for (uint32_t scale = gridSize / 2; scale > 0; scale /= 2) {
+            uint32_t isRight = (cell[0] & scale) > 0;
+            uint32_t isTop = (cell[1] & scale) > 0;
+            curveIndex += static_cast<uint64_t>(scale) * scale * ((3 * isRight) ^ isTop);
+            // Rotate the quadrant so the curve inside it runs the right way
+            if (isTop == 0) {
+                if (isRight == 1) {
+                    cell[0] = gridSize - 1 - cell[0];
+                    cell[1] = gridSize - 1 - cell[1];
+                }
+                std::swap(cell[0], cell[1]);
             }
         }
+        curveIndices[nodeID] = curveIndex;
     }
+    std::vector<int> order(nodes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&curveIndices](const int &a, const int &b) {
+        return curveIndices[a] < curveIndices[b];
+    });
+    return order;
+}
+
+/**
+ * @brief Get the reverse Cuthill-McKee order of the nodes, which numbers connected nodes close together
+ * @return Vector where order[newID] is the current ID of the node given newID
+ */
+std::vector<int> Network::getCuthillMcKeeOrder() const {
+    // Start each connected component from one of its least connected nodes
+    std::vector<int> startNodes(nodes.size());
+    std::iota(startNodes.begin(), startNodes.end(), 0);
+    auto isLessConnected = [this](const int &a, const int &b) {
+        return nodes[a].netConnections.size() < nodes[b].netConnections.size();
+    };
+    std::stable_sort(startNodes.begin(), startNodes.end(), isLessConnected);
+
+    std::vector<int> order;
+    order.reserve(nodes.size());
+    std::vector<bool> isVisited(nodes.size(), false);
+    std::vector<int> neighbours;
+    for (const int &startNode : startNodes) {
+        if (isVisited[startNode]) {
+            continue;
+        }
+        isVisited[startNode] = true;
+        // order doubles as the breadth first search queue
+        size_t queueIndex = order.size();
+        order.push_back(startNode);
+        for (; queueIndex < order.size(); ++queueIndex) {
+            neighbours.clear();
+            for (const int &neighbour : nodes[order[queueIndex]].netConnections) {
+                if (!isVisited[neighbour]) {
+                    isVisited[neighbour] = true;
+                    neighbours.push_back(neighbour);
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(), isLessConnected);
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * @brief Renumber the nodes of the network, keeping the order of every node's connections
+ * @param order Vector where order[newID] is the current ID of the node given newID
+ * @param dualOrder The same for the nodes of the dual network, which dual connections refer to
+ * @throw std::invalid_argument if order does not have one entry per node
+ */
+void Network::renumber(const std::vector<int> &order, const std::vector<int> &dualOrder) {
+    if (order.size() != nodes.size()) {
+        throw std::invalid_argument("Node order has " + std::to_string(order.size()) + " entries for " +
+                                    std::to_string(nodes.size()) + " nodes");
+    }
+    std::vector<int> newIDs = invertPermutation(order);
+    std::vector<int> newDualIDs = invertPermutation(dualOrder);
+    std::vector<Node> renumberedNodes;
+    renumberedNodes.reserve(nodes.size());
+    for (int newID = 0; newID < order.size(); ++newID) {
+        Node &node = renumberedNodes.emplace_back(std::move(nodes[order[newID]]));
+        node.id = newID;
+        for (int &connection : node.netConnections) {
+            connection = newIDs[connection];
+        }
+        for (int &dualConnection : node.dualConnections) {
+            dualConnection = newDualIDs[dualConnection];
+        }
+    }
+    nodes = std::move(renumberedNodes);
 }
 
 /**
@@ -389,15 +666,16 @@ std::vector<std::vector<int>> Network::getDualConnections() const {
 
 /**
  * @brief Write network to files
+ * @param directory The folder to write the files to, which must exist
  */
-void Network::write() const {
-    std::ofstream infoFile(std::filesystem::path("./output_files") / (networkString + "_info.txt"), std::ios::in | std::ios::trunc);
+void Network::write(const std::string &directory) const {
+    std::ofstream infoFile(std::filesystem::path(directory) / (networkString + "_info.txt"), std::ios::in | std::ios::trunc);
     writeInfo(infoFile);
-    std::ofstream crdFile(std::filesystem::path("./output_files") / (networkString + "_coords.txt"), std::ios::in | std::ios::trunc);
+    std::ofstream crdFile(std::filesystem::path(directory) / (networkString + "_coords.txt"), std::ios::in | std::ios::trunc);
     writeCoords(crdFile);
-    std::ofstream netFile(std::filesystem::path("./output_files") / (networkString + "_connections.txt"), std::ios::in | std::ios::trunc);
+    std::ofstream netFile(std::filesystem::path(directory) / (networkString + "_connections.txt"), std::ios::in | std::ios::trunc);
     writeConnections(netFile, getConnections());
-    std::ofstream dualFile(std::filesystem::path("./output_files") / (networkString + "_dual_connections.txt"), std::ios::in | std::ios::trunc);
+    std::ofstream dualFile(std::filesystem::path(directory) / (networkString + "_dual_connections.txt"), std::ios::in | std::ios::trunc);
     writeConnections(dualFile, getDualConnections());
 }
 /**
@@ -509,8 +787,141 @@ std::vector<double> Network::getCoords() {
     return returnCoords;
 }
 
+/**
+ * @brief Release the spare capacity of every node's vectors
+ */
+void Network::shrinkToFit() {
+    nodes.shrink_to_fit();
+    std::for_each(nodes.begin(), nodes.end(), [](Node &node) {
+        node.crd.shrink_to_fit();
+        node.netConnections.shrink_to_fit();
+        node.dualConnections.shrink_to_fit();
+    });
+}
+
+/**
+ * @brief Estimate the memory used by the network, including the heap allocations of every node
+ * @return Number of bytes
+ */
+size_t Network::getMemoryUsage() const {
+    size_t numBytes = sizeof(Network) + nodes.capacity() * sizeof(Node);
+    std::for_each(nodes.begin(), nodes.end(), [&numBytes](const Node &node) {
+        numBytes += node.crd.capacity() * sizeof(double) +
+                    node.netConnections.capacity() * sizeof(int) +
+                    node.dualConnections.capacity() * sizeof(int);
+    });
+    return numBytes;
+}
+
+/**
+ * @brief Get the Aboav-Weaire parameter of the network by fitting n m(n) = (<n> - a) n + <n> a + mu_2,
+ * where m(n) is the mean coordination of the neighbours of nodes with coordination n
+ * @return Aboav-Weaire parameter a, or 0 if there are fewer than two distinct coordinations
+ */
 double Network::getAboavWeaire() const {
-    return 0.0;
+    std::map<int, double> neighbourCoordinationSums;
+    std::map<int, int> nodeCounts;
+    std::for_each(nodes.begin(), nodes.end(), [this, &neighbourCoordinationSums, &nodeCounts](const Node &node) {
+        if (node.netConnections.empty()) {
+            return;
+        }
+        int coordination = node.netConnections.size();
+        for (const int &cnx : node.netConnections) {
+            neighbourCoordinationSums[coordination] += nodes[cnx].netConnections.size();
+        }
+        ++nodeCounts[coordination];
+    });
+    if (nodeCounts.size() < 2) {
+        return 0.0;
+    }
+    std::vector<double> coordinations;
+    std::vector<double> neighbourSums;
+    for (const auto &[coordination, count] : nodeCounts) {
+        // n m(n) is the total coordination of a node's neighbours
+        coordinations.push_back(coordination);
+        neighbourSums.push_back(neighbourCoordinationSums[coordination] / count);
+    }
+    auto [gradient, intercept, rSquared] = vectorLinearRegression(coordinations, neighbourSums);
+    return getAverageCoordination() - gradient;
+}
+
+/**
+ * @brief Get the areas of all rings, treating this network as the dual of a base network
+ * @param baseNetwork Base network providing the coordinates of each ring's nodes
+ * @return Vector of areas of all rings
+ */
+std::vector<double> Network::getRingAreas(const Network &baseNetwork) const {
+    std::vector<double> ringAreas;
+    ringAreas.reserve(nodes.size());
+    std::for_each(nodes.begin(), nodes.end(), [&baseNetwork, &ringAreas, this](const Node &ringNode) {
+        std::vector<std::vector<double>> baseNodeCoords;
+        baseNodeCoords.reserve(ringNode.dualConnections.size());
+        for (const int &baseNodeID : ringNode.dualConnections) {
+            baseNodeCoords.push_back(pbcVector(ringNode.crd, baseNetwork.nodes[baseNodeID].crd, dimensions));
+        }
+        ringAreas.push_back(calculatePolygonArea(baseNodeCoords));
+    });
+    return ringAreas;
+}
+
+/**
+ * @brief Get the length of every bond in the network, counting each bond once
+ * @return Vector of bond lengths
+ */
+std::vector<double> Network::getBondLengths() const {
+    std::vector<double> bondLengths;
+    std::for_each(nodes.begin(), nodes.end(), [&bondLengths, this](const Node &node) {
+        for (const int &cnx : node.netConnections) {
+            if (cnx > node.id) {
+                std::vector<double> bondVector = pbcVector(node.crd, nodes[cnx].crd, dimensions);
+                bondLengths.push_back(std::hypot(bondVector[0], bondVector[1]));
+            }
+        }
+    });
+    return bondLengths;
+}
+
+/**
+ * @brief Get the angles between neighbouring bonds around every node, so the angles around a node sum to 2 pi
+ * @return Vector of bond angles in radians
+ */
+std::vector<double> Network::getBondAngles() const {
+    std::vector<double> bondAngles;
+    std::vector<double> directions;
+    std::for_each(nodes.begin(), nodes.end(), [&bondAngles, &directions, this](const Node &node) {
+        if (node.netConnections.size() < 2) {
+            return;
+        }
+        directions.clear();
+        for (const int &cnx : node.netConnections) {
+            directions.push_back(getClockwiseAngle(node.crd, nodes[cnx].crd, dimensions));
+        }
+        std::sort(directions.begin(), directions.end());
+        for (size_t i = 1; i < directions.size(); ++i) {
+            bondAngles.push_back(directions[i] - directions[i - 1]);
+        }
+        bondAngles.push_back(directions.front() + 2 * M_PI - directions.back());
+    });
+    return bondAngles;
+}
+
+/**
+ * @brief Get every bond and angle in the network, for building the LAMMPS topology
+ * @param bonds Vector to hold the zero-indexed IDs of every bond (1D vector of pairs)
+ * @param angles Vector to hold the zero-indexed IDs of every angle with the central node in the middle (1D vector of triples)
+ */
+void Network::getBondsAndAngles(std::vector<int> &bonds, std::vector<int> &angles) const {
+    for (const Node &node : nodes) {
+        const std::vector<int> &neighbours = node.netConnections;
+        for (size_t i = 0; i < neighbours.size(); ++i) {
+            if (neighbours[i] > node.id) {
+                vectorAddValues(bonds, node.id, neighbours[i]);
+            }
+            for (size_t j = i + 1; j < neighbours.size(); ++j) {
+                vectorAddValues(angles, neighbours[i], node.id, neighbours[j]);
+            }
+        }
+    }
 }
 
 void Network::refreshStatistics() {
@@ -0,0 +1,82 @@
+#include "relaxation_templates.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Default constructor for disabled templates
+ */
+RelaxationTemplates::RelaxationTemplates() = default;
+
+/**
+ * @brief Construct an empty set of templates
+ * @param isEnabledArg Learn and apply templates
+ */
+RelaxationTemplates::RelaxationTemplates(const bool &isEnabledArg) : isEnabled(isEnabledArg) {
+}
+
+/**
+ * @brief Get the template case of a switch from the sizes of the two rings that lose a node
+ * @param ringSize1 Size of ringNode1 before the switch
+ * @param ringSize2 Size of ringNode2 before the switch
+ * @return Index of the case between 0 and NUM_CASES - 1
+ * @throw std::invalid_argument if either ring has fewer than 4 nodes
+ */
+int RelaxationTemplates::getCase(const int &ringSize1, const int &ringSize2) {
+    if (ringSize1 < 4 || ringSize2 < 4) {
+        throw std::invalid_argument("Switched rings must have at least 4 nodes");
+    }
+    return 3 * (std::min(ringSize2, 6) - 4) + std::min(ringSize1, 6) - 4;
+}
+
+/**
+ * @brief Get the template of a case if it has learned from enough relaxations to be applied
+ * @param switchCase Index of the case
+ * @return Pointer to the template, or nullptr if disabled or it has too few samples
+ */
+const RelaxationTemplates::Template *RelaxationTemplates::find(const int &switchCase) const {
+    if (!isEnabled || templates[switchCase].numSamples < MIN_SAMPLES) {
+        return nullptr;
+    }
+    return &templates[switchCase];
+}
+
+/**
+ * @brief Update the template of a case with the displacements of a completed relaxation
+ * @param switchCase Index of the case
+ * @param displacements Displacement of each shell node in the frame of the switched bond, as a 1D vector of pairs
+ */
+void RelaxationTemplates::learn(const int &switchCase, const std::vector<double> &displacements) {
+    Template &relaxationTemplate = templates[switchCase];
+    relaxationTemplate.numSamples++;
+    double weight = 1.0 / std::min(relaxationTemplate.numSamples, MAX_SAMPLES);
+    for (size_t i = 0; i < displacements.size(); ++i) {
+        relaxationTemplate.displacements[i] += weight * (displacements[i] - relaxationTemplate.displacements[i]);
+    }
+}
+
+/**
+ * @brief Record the number of iterations a minimisation took
+ * @param isTemplateApplied Whether the minimisation was started from a template
+ * @param iterations Number of minimiser iterations
+ */
+void RelaxationTemplates::recordIterations(const bool &isTemplateApplied, const int &iterations) {
+    if (isTemplateApplied) {
+        numWithTemplate++;
+        iterationsWithTemplate += iterations;
+    } else {
+        numWithoutTemplate++;
+        iterationsWithoutTemplate += iterations;
+    }
+}
+
+/**
+ * @brief Get the mean number of iterations of minimisations started with or without a template
+ * @param isTemplateApplied Whether to average minimisations started from a template
+ * @return Mean number of iterations, or 0 if there have been no such minimisations
+ */
+double RelaxationTemplates::getMeanIterations(const bool &isTemplateApplied) const {
+    if (isTemplateApplied) {
+        return numWithTemplate == 0 ? 0.0 : static_cast<double>(iterationsWithTemplate) / numWithTemplate;
+    }
+    return numWithoutTemplate == 0 ? 0.0 : static_cast<double>(iterationsWithoutTemplate) / numWithoutTemplate;
+}
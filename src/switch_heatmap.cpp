@@ -0,0 +1,142 @@
+#include "switch_heatmap.h"
+#include "vector_tools.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Default constructor, disabled
+ */
+SwitchHeatmap::SwitchHeatmap() = default;
+
+/**
+ * @brief Construct an empty grid over the periodic box
+ * @param gridSizeArg Number of cells along each side of the box, 0 to disable
+ * @param dimensionsArg Periodic boundary of the network
+ */
+SwitchHeatmap::SwitchHeatmap(const int &gridSizeArg, const std::vector<double> &dimensionsArg)
+    : gridSize(gridSizeArg),
+      dimensions(dimensionsArg),
+      proposals(gridSizeArg * gridSizeArg, 0),
+      accepted(gridSizeArg * gridSizeArg, 0),
+      failedAngleChecks(gridSizeArg * gridSizeArg, 0),
+      failedBondLengthChecks(gridSizeArg * gridSizeArg, 0),
+      failedEnergyChecks(gridSizeArg * gridSizeArg, 0),
+      relaxations(gridSizeArg * gridSizeArg, 0),
+      relaxationTimes(gridSizeArg * gridSizeArg, 0.0) {
+}
+
+/**
+ * @brief Check if switches are being counted
+ * @return true if the grid has any cells, false otherwise
+ */
+bool SwitchHeatmap::isEnabled() const {
+    return gridSize > 0;
+}
+
+/**
+ * @brief Get the cell holding the midpoint of a bond, taking the shorter way across the periodic boundary
+ * @param coord1 Coordinates of the first node of the bond
+ * @param coord2 Coordinates of the second node of the bond
+ * @return Index of the cell, or -1 if the heatmap is disabled
+ */
+int SwitchHeatmap::getCell(const std::vector<double> &coord1, const std::vector<double> &coord2) const {
+    if (!isEnabled()) {
+        return -1;
+    }
+    std::vector<double> bond = pbcVector(coord1, coord2, dimensions);
+    std::vector<int> indices(2);
+    for (int i = 0; i < 2; ++i) {
+        double midpoint = coord1[i] + bond[i] / 2.0;
+        midpoint -= dimensions[i] * std::floor(midpoint / dimensions[i]);
+        indices[i] = std::clamp(static_cast<int>(midpoint / dimensions[i] * gridSize), 0, gridSize - 1);
+    }
+    return indices[1] * gridSize + indices[0];
+}
+
+/**
+ * @brief Count a proposal and its outcome
+ * @param cell Index of the cell of the switched bond, ignored if -1
+ * @param outcome Whether the proposal was accepted, or which check rejected it
+ */
+void SwitchHeatmap::record(const int &cell, const SwitchOutcome &outcome) {
+    if (cell < 0) {
+        return;
+    }
+    proposals[cell]++;
+    switch (outcome) {
+    case SwitchOutcome::ACCEPTED:
+        accepted[cell]++;
+        break;
+    case SwitchOutcome::FAILED_ANGLE_CHECK:
+        failedAngleChecks[cell]++;
+        break;
+    case SwitchOutcome::FAILED_BOND_LENGTH_CHECK:
+        failedBondLengthChecks[cell]++;
+        break;
+    case SwitchOutcome::FAILED_ENERGY_CHECK:
+        failedEnergyChecks[cell]++;
+        break;
+    }
+}
+
+/**
+ * @brief Count the time spent minimising a proposal
+ * @param cell Index of the cell of the switched bond, ignored if -1
+ * @param relaxationTime Time spent minimising (ms)
+ */
+void SwitchHeatmap::recordRelaxation(const int &cell, const double &relaxationTime) {
+    if (cell < 0) {
+        return;
+    }
+    relaxations[cell]++;
+    relaxationTimes[cell] += relaxationTime;
+}
+
+/**
+ * @brief Add the counts of another heatmap over the same grid, such as that of another walker
+ * @param other The heatmap to add
+ */
+void SwitchHeatmap::add(const SwitchHeatmap &other) {
+    if (other.gridSize != gridSize) {
+        return;
+    }
+    for (size_t cell = 0; cell < proposals.size(); ++cell) {
+        proposals[cell] += other.proposals[cell];
+        accepted[cell] += other.accepted[cell];
+        failedAngleChecks[cell] += other.failedAngleChecks[cell];
+        failedBondLengthChecks[cell] += other.failedBondLengthChecks[cell];
+        failedEnergyChecks[cell] += other.failedEnergyChecks[cell];
+        relaxations[cell] += other.relaxations[cell];
+        relaxationTimes[cell] += other.relaxationTimes[cell];
+    }
+}
+
+/**
+ * @brief Write the counts so far as gridSize x gridSize arrays, each headed by the step and the name of the count.
+ * Rows run from the lowest y upwards and columns from the lowest x.
+ * @param file The file to write to
+ * @param step The current step
+ */
+void SwitchHeatmap::write(OutputFile &file, const int &step) const {
+    if (!isEnabled()) {
+        return;
+    }
+    auto writeArray = [this, &file, &step](const std::string &name, const auto &getValue) {
+        file.writeLine(std::to_string(step) + ", " + name);
+        for (int row = 0; row < gridSize; ++row) {
+            std::ostringstream line;
+            for (int column = 0; column < gridSize; ++column) {
+                line << (column > 0 ? "," : "") << getValue(row * gridSize + column);
+            }
+            file.writeLine(line.str());
+        }
+    };
+    writeArray("Proposals", [this](const int &cell) { return proposals[cell]; });
+    writeArray("Accepted", [this](const int &cell) { return accepted[cell]; });
+    writeArray("Failed Angle Checks", [this](const int &cell) { return failedAngleChecks[cell]; });
+    writeArray("Failed Bond Length Checks", [this](const int &cell) { return failedBondLengthChecks[cell]; });
+    writeArray("Failed Energy Checks", [this](const int &cell) { return failedEnergyChecks[cell]; });
+    writeArray("Mean Relaxation Time (ms)", [this](const int &cell) {
+        return relaxations[cell] > 0 ? relaxationTimes[cell] / relaxations[cell] : 0.0;
+    });
+}
@@ -0,0 +1,132 @@
+#include "topology_cache.h"
+#include <algorithm>
+#include <filesystem>
+
+/**
+ * @brief Default constructor for a disabled cache
+ */
+TopologyCache::TopologyCache() = default;
+
+/**
+ * @brief Construct a cache holding at most a given number of relaxed networks
+ * @param capacityArg Maximum number of entries, 0 disables the cache
+ * @param isMappedArg Store coordinates in a memory mapped file in the output folder rather than on the heap
+ */
+TopologyCache::TopologyCache(const size_t &capacityArg, const bool &isMappedArg) : capacity(capacityArg), isMapped(isMappedArg) {
+    lookup.reserve(capacity);
+}
+
+/**
+ * @brief Get the Zobrist key of a bond. Keys are generated on the fly with splitmix64 rather
+ * than stored in a table, so any pair of node IDs has a fixed pseudo-random key
+ * @param node1 ID of the first node in the bond
+ * @param node2 ID of the second node in the bond
+ * @return 64 bit key that is independent of the order of the nodes
+ */
+uint64_t TopologyCache::bondKey(const int &node1, const int &node2) {
+    uint64_t key = (static_cast<uint64_t>(std::min(node1, node2)) << 32) | static_cast<uint32_t>(std::max(node1, node2));
+    key += 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+/**
+ * @brief Check if the cache can hold any entries
+ * @return true if the capacity is greater than 0, false otherwise
+ */
+bool TopologyCache::isEnabled() const {
+    return capacity > 0;
+}
+
+/**
+ * @brief Look up a relaxed network and mark it as most recently used
+ * @param hash Zobrist hash of the network topology
+ * @return Pointer to the cached entry, or nullptr if the topology has not been cached
+ */
+const TopologyCache::Entry *TopologyCache::find(const uint64_t &hash) {
+    auto it = lookup.find(hash);
+    if (it == lookup.end()) {
+        misses++;
+        return nullptr;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->second;
+}
+
+/**
+ * @brief Add a relaxed network to the cache, evicting the least recently used entry if full
+ * @param hash Zobrist hash of the network topology
+ * @param energy Relaxed potential energy of the network
+ * @param coords Relaxed coordinates of the network as a 1D vector of pairs
+ */
+void TopologyCache::insert(const uint64_t &hash, const double &energy, const std::vector<double> &coords) {
+    if (!isEnabled()) {
+        return;
+    }
+    if (entrySize == 0) {
+        entrySize = coords.size();
+        if (isMapped) {
+            mappedCoords = MappedArray(std::filesystem::path("./output_files"), capacity * entrySize);
+        }
+    }
+    size_t slot;
+    if (auto it = lookup.find(hash); it != lookup.end()) {
+        slot = it->second->second.slot;
+        entries.erase(it->second);
+        lookup.erase(it);
+    } else if (entries.size() >= capacity) {
+        slot = entries.back().second.slot;
+        lookup.erase(entries.back().first);
+        entries.pop_back();
+    } else {
+        slot = entries.size();
+    }
+    float *slotCoords;
+    if (isMapped) {
+        slotCoords = mappedCoords.data + slot * entrySize;
+    } else {
+        if (heapCoords.size() < (slot + 1) * entrySize) {
+            heapCoords.resize((slot + 1) * entrySize);
+        }
+        slotCoords = heapCoords.data() + slot * entrySize;
+    }
+    std::copy(coords.begin(), coords.end(), slotCoords);
+    entries.emplace_front(hash, Entry{energy, slot});
+    lookup[hash] = entries.begin();
+}
+
+/**
+ * @brief Get the relaxed coordinates of a cached network
+ * @param entry The cached entry
+ * @return Pointer to the first of entrySize single precision coordinates
+ */
+const float *TopologyCache::getCoords(const Entry &entry) const {
+    if (isMapped) {
+        return mappedCoords.data + entry.slot * entrySize;
+    }
+    return heapCoords.data() + entry.slot * entrySize;
+}
+
+/**
+ * @brief Get the fraction of lookups that found a cached network
+ * @return Hit rate between 0 and 1, or 0 if there have been no lookups
+ */
+double TopologyCache::getHitRate() const {
+    if (hits + misses == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(hits) / (hits + misses);
+}
+
+/**
+ * @brief Estimate the heap memory used by the cache, excluding any memory mapped coordinates
+ * @return Number of bytes
+ */
+size_t TopologyCache::getMemoryUsage() const {
+    size_t listNodeSize = sizeof(std::pair<uint64_t, Entry>) + 2 * sizeof(void *);
+    size_t lookupNodeSize = sizeof(uint64_t) + 3 * sizeof(void *);
+    return sizeof(TopologyCache) + entries.size() * listNodeSize + lookup.size() * lookupNodeSize +
+           lookup.bucket_count() * sizeof(void *) + heapCoords.capacity() * sizeof(float);
+}
@@ -132,4 +132,17 @@ double calculatePolygonArea(std::vector<std::vector<double>> &vertices) {
     area += vertices.back()[0] * vertices.front()[1] - vertices.front()[0] * vertices.back()[1];
     area /= 2.0;
     return std::abs(area);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Inverts a permutation of 0 to n - 1
+ * @param permutation Vector where permutation[i] is the value i is mapped to
+ * @return Vector where inverse[permutation[i]] = i
+ */
+std::vector<int> invertPermutation(const std::vector<int> &permutation) {
+    std::vector<int> inverse(permutation.size());
+    for (int i = 0; i < permutation.size(); ++i) {
+        inverse[permutation[i]] = i;
+    }
+    return inverse;
+}
@@ -0,0 +1,242 @@
+#include "wang_landau.h"
+#include "vector_tools.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+
+/**
+ * @brief Construct an estimate with a flat density of states
+ * @param orderParameterArg The quantity whose density of states is estimated
+ * @param referenceEnergyArg Energy of the starting network, energies are binned relative to it
+ * @param minimumArg Lower edge of the first bin
+ * @param maximumArg Upper edge of the last bin
+ * @param numBins Number of bins between the minimum and maximum
+ * @param flatnessArg Fewest visits to any visited bin as a fraction of the mean for the histogram to be flat
+ * @param finalModificationArg Sampling has converged once ln f falls below this
+ * @param minRingSizeArg Smallest ring size whose fraction is averaged over each bin
+ * @param maxRingSize Largest ring size whose fraction is averaged over each bin
+ * @param loggerArg The logger to log to
+ * @throw std::invalid_argument if the maximum is not above the minimum
+ */
+WangLandau::WangLandau(const OrderParameter &orderParameterArg, const double &referenceEnergyArg, const double &minimumArg,
+                       const double &maximumArg, const int &numBins, const double &flatnessArg, const double &finalModificationArg,
+                       const int &minRingSizeArg, const int &maxRingSize, const LoggerPtr &loggerArg)
+    : orderParameter(orderParameterArg),
+      referenceEnergy(referenceEnergyArg),
+      minimum(minimumArg),
+      maximum(maximumArg),
+      binWidth((maximumArg - minimumArg) / numBins),
+      flatness(flatnessArg),
+      finalModification(finalModificationArg),
+      minRingSize(minRingSizeArg),
+      lnDensity(numBins, 0.0),
+      histogram(numBins, 0),
+      isVisited(numBins, false),
+      numVisits(numBins, 0),
+      ringSizeSums(numBins, std::vector<double>(maxRingSize - minRingSizeArg + 1, 0.0)),
+      logger(loggerArg) {
+    if (maximum <= minimum) {
+        throw std::invalid_argument("Wang-Landau maximum must be greater than the minimum");
+    }
+}
+
+/**
+ * @brief Get the order parameter of a network
+ * @param energy The potential energy of the network
+ * @param numHexagons The number of six-membered rings in the network
+ * @param numRings The number of rings in the network
+ * @return The energy relative to the reference energy, or the fraction of rings that are hexagons
+ */
+double WangLandau::getOrderParameter(const double &energy, const int &numHexagons, const int &numRings) const {
+    if (orderParameter == OrderParameter::ENERGY) {
+        return energy - referenceEnergy;
+    }
+    return static_cast<double>(numHexagons) / numRings;
+}
+
+/**
+ * @brief Get the bin an order parameter falls in
+ * @param value The order parameter
+ * @return The index of the bin, or -1 if the value is outside every bin
+ */
+int WangLandau::getBin(const double &value) const {
+    if (value < minimum || value > maximum) {
+        return -1;
+    }
+    return std::min(static_cast<int>((value - minimum) / binWidth), static_cast<int>(lnDensity.size()) - 1);
+}
+
+/**
+ * @brief Get the order parameter at the centre of a bin
+ * @param bin The index of the bin
+ * @return The centre of the bin
+ */
+double WangLandau::getBinCentre(const int &bin) const {
+    return minimum + (bin + 0.5) * binWidth;
+}
+
+/**
+ * @brief Decide whether to accept a move, with probability g(initial) / g(final) so that every bin is visited
+ * equally often. Sampling the fraction of hexagons also weights by the Boltzmann factor, so the density of states
+ * becomes the distribution of the fraction at that temperature. Moves leaving the bins are rejected, and a walker
+ * that starts outside the bins accepts any move that does not take it further away.
+ * @param initialValue The order parameter before the move
+ * @param finalValue The order parameter after the move
+ * @param energyChange The change in energy of the move
+ * @param temperature The temperature of the Boltzmann factor when sampling the fraction of hexagons
+ * @param randomNumber A uniform random number in [0, 1)
+ * @return true if the move is accepted, false otherwise
+ */
+bool WangLandau::acceptanceCriterion(const double &initialValue, const double &finalValue, const double &energyChange,
+                                     const double &temperature, const double &randomNumber) {
+    int initialBin = getBin(initialValue);
+    int finalBin = getBin(finalValue);
+    if (initialBin < 0) {
+        auto distance = [this](const double &value) { return std::max({minimum - value, value - maximum, 0.0}); };
+        return distance(finalValue) <= distance(initialValue);
+    }
+    if (finalBin < 0) {
+        return false;
+    }
+    double lnProbability;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        lnProbability = lnDensity[initialBin] - lnDensity[finalBin];
+    }
+    if (orderParameter == OrderParameter::HEXAGON_FRACTION) {
+        lnProbability -= energyChange / temperature;
+    }
+    return lnProbability >= 0.0 || randomNumber < std::exp(lnProbability);
+}
+
+/**
+ * @brief Record a visit to the bin of the current network, raising its density of states. When the histogram is
+ * flat the modification factor is halved and the histogram is cleared.
+ * @param value The order parameter of the current network
+ * @param ringSizeFractions Fraction of rings of each size from the smallest allowed ring size upwards
+ */
+void WangLandau::visit(const double &value, const std::vector<double> &ringSizeFractions) {
+    int bin = getBin(value);
+    if (bin < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    lnDensity[bin] += lnModification;
+    histogram[bin]++;
+    isVisited[bin] = true;
+    numVisits[bin]++;
+    for (size_t i = 0; i < ringSizeFractions.size() && i < ringSizeSums[bin].size(); ++i) {
+        ringSizeSums[bin][i] += ringSizeFractions[i];
+    }
+    if (isFlat()) {
+        numIterations++;
+        logger->info("Wang-Landau histogram flat after iteration {} with ln f = {:.2e}, visited {} of {} bins", numIterations,
+                     lnModification, std::count(isVisited.begin(), isVisited.end(), true), lnDensity.size());
+        lnModification /= 2;
+        std::fill(histogram.begin(), histogram.end(), 0);
+    }
+}
+
+/**
+ * @brief Check if every visited bin has been visited at least flatness times the mean since the last iteration
+ * @return true if the histogram is flat, false otherwise
+ */
+bool WangLandau::isFlat() const {
+    long long minVisits = std::numeric_limits<long long>::max();
+    long long totalVisits = 0;
+    int numVisitedBins = 0;
+    for (size_t bin = 0; bin < histogram.size(); ++bin) {
+        if (isVisited[bin]) {
+            minVisits = std::min(minVisits, histogram[bin]);
+            totalVisits += histogram[bin];
+            numVisitedBins++;
+        }
+    }
+    // A single visited bin is trivially flat, so at least two are needed
+    return numVisitedBins > 1 && minVisits >= flatness * totalVisits / numVisitedBins;
+}
+
+/**
+ * @brief Check if the modification factor has fallen below its final value
+ * @return true if sampling has converged, false otherwise
+ */
+bool WangLandau::isConverged() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lnModification < finalModification;
+}
+
+/**
+ * @brief Write the density of states and the mean ring size fractions of every bin to wang_landau.csv. When the
+ * energy is sampled, also write the mean energy, heat capacity and ring size fractions at every temperature to
+ * wang_landau_thermodynamics.csv, reweighting the bins by their Boltzmann factors.
+ * @param directory The folder to write the files to
+ * @param temperatures The temperatures to find the thermodynamics at
+ */
+void WangLandau::write(const std::string &directory, const std::vector<double> &temperatures) const {
+    int maxRingSize = minRingSize + static_cast<int>(ringSizeSums.front().size()) - 1;
+    std::ostringstream ringSizeHeader;
+    for (int ringSize = minRingSize; ringSize <= maxRingSize; ++ringSize) {
+        ringSizeHeader << ", P(" << ringSize << ")";
+    }
+
+    OutputFile densityFile(std::filesystem::path(directory) / "wang_landau.csv");
+    densityFile.writeLine(orderParameter == OrderParameter::ENERGY ? "Energy relative to the starting network (Eh)" : "Fraction of hexagons");
+    densityFile.writeLine("Bin Centre, ln g, Visits" + ringSizeHeader.str());
+    std::vector<std::vector<double>> meanRingSizes(lnDensity.size());
+    for (size_t bin = 0; bin < lnDensity.size(); ++bin) {
+        if (!isVisited[bin]) {
+            continue;
+        }
+        meanRingSizes[bin] = ringSizeSums[bin];
+        vectorDivide(meanRingSizes[bin], static_cast<double>(numVisits[bin]));
+        std::ostringstream row;
+        row << getBinCentre(bin) << "," << lnDensity[bin] << "," << numVisits[bin];
+        for (const double &fraction : meanRingSizes[bin]) {
+            row << "," << fraction;
+        }
+        densityFile.writeLine(row.str());
+    }
+
+    if (orderParameter != OrderParameter::ENERGY) {
+        return;
+    }
+    OutputFile thermodynamicsFile(std::filesystem::path(directory) / "wang_landau_thermodynamics.csv");
+    thermodynamicsFile.writeLine("Temperature, Mean Energy (Eh), Heat Capacity" + ringSizeHeader.str());
+    for (const double &temperature : temperatures) {
+        // Subtract the largest log weight so that the exponentials do not overflow
+        double maxLnWeight = -std::numeric_limits<double>::infinity();
+        for (size_t bin = 0; bin < lnDensity.size(); ++bin) {
+            if (isVisited[bin]) {
+                maxLnWeight = std::max(maxLnWeight, lnDensity[bin] - getBinCentre(bin) / temperature);
+            }
+        }
+        double partitionFunction = 0.0;
+        double meanEnergy = 0.0;
+        double meanSquareEnergy = 0.0;
+        std::vector<double> ringSizes(ringSizeSums.front().size(), 0.0);
+        for (size_t bin = 0; bin < lnDensity.size(); ++bin) {
+            if (!isVisited[bin]) {
+                continue;
+            }
+            double energy = getBinCentre(bin);
+            double weight = std::exp(lnDensity[bin] - energy / temperature - maxLnWeight);
+            partitionFunction += weight;
+            meanEnergy += weight * energy;
+            meanSquareEnergy += weight * energy * energy;
+            for (size_t i = 0; i < ringSizes.size(); ++i) {
+                ringSizes[i] += weight * meanRingSizes[bin][i];
+            }
+        }
+        meanEnergy /= partitionFunction;
+        meanSquareEnergy /= partitionFunction;
+        vectorDivide(ringSizes, partitionFunction);
+        std::ostringstream row;
+        row << temperature << "," << meanEnergy + referenceEnergy << ","
+            << (meanSquareEnergy - meanEnergy * meanEnergy) / (temperature * temperature);
+        for (const double &fraction : ringSizes) {
+            row << "," << fraction;
+        }
+        thermodynamicsFile.writeLine(row.str());
+    }
+}